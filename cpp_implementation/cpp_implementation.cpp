@@ -4,7 +4,9 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
-#include <iomanip>
+#include <stdexcept>
+
+#include "rank_output.h"
 
 class Node
 {
@@ -248,44 +250,95 @@ void pageRank(Graph *graph, double d, int iteration = 100)
     }
 }
 
-void outputPageRank(int iteration, Graph *graph, double damping_factor, const std::string &result_dir, const std::string &fname)
+void outputPageRank(int iteration, Graph *graph, double damping_factor, const std::string &result_dir, const std::string &fname,
+                    const RankOutputOptions &options = RankOutputOptions())
 {
-    std::string pagerank_fname = "_PageRank.txt";
+    std::string pagerank_fname = "_PageRank";
     pageRank(graph, damping_factor, iteration);
     std::vector<double> pagerank_list = graph->getPagerankList();
 
-    std::cout << "PageRank:" << std::endl;
-    for (double pr : pagerank_list)
+    std::vector<std::string> names;
+    for (Node *node : graph->nodes)
     {
-        std::cout << pr << " ";
+        names.push_back(node->name);
     }
-    std::cout << std::endl;
 
     std::string path = result_dir + "/" + fname;
-    std::ofstream outfile(path + pagerank_fname);
-    if (outfile.is_open())
-    {
-        for (double pr : pagerank_list)
-        {
-            outfile << std::fixed << std::setprecision(3) << pr << " ";
-        }
-        outfile << std::endl;
-        outfile.close();
-    }
+    writeRanks(pagerank_list, names, "PageRank", path + pagerank_fname, options);
 }
 
-int main()
+int main(int argc, char **argv)
 {
     std::string input_file = "dataset/graph_1.txt";
     double damping_factor = 0.15;
     // double decay_factor = 0.9;
     int iteration = 500;
+    RankOutputOptions options;
+
+    std::string usage = std::string("usage: ") + argv[0] +
+                        " [input_file] [--iteration N] [--top K] [--format text|bin32|bin64|none] [--precision P] [--print|--quiet]";
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--top" && hasValue)
+            {
+                options.topK = std::stoi(argv[++i]);
+            }
+            else if (arg == "--format" && hasValue)
+            {
+                if (!parseRankFormat(argv[++i], options.format))
+                {
+                    std::cerr << "unknown format " << argv[i] << " (expected text, bin32, bin64 or none)" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--precision" && hasValue)
+            {
+                options.precision = std::stoi(argv[++i]);
+                if (options.precision < 0)
+                {
+                    std::cerr << "precision must not be negative" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--print")
+            {
+                options.printLimit = (std::size_t)-1;
+            }
+            else if (arg == "--quiet")
+            {
+                options.printLimit = 0;
+            }
+            else if (arg == "--iteration" && hasValue)
+            {
+                iteration = std::stoi(argv[++i]);
+            }
+            else if (arg[0] != '-')
+            {
+                input_file = arg;
+            }
+            else
+            {
+                std::cerr << usage << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch (const std::logic_error &)
+    {
+        // std::stoi throws invalid_argument or out_of_range on a bad number
+        std::cerr << usage << std::endl;
+        return 1;
+    }
 
     std::string result_dir = "result";
     std::string fname = input_file.substr(input_file.find_last_of("/") + 1, input_file.find_last_of(".") - input_file.find_last_of("/") - 1);
 
     Graph *graph = initGraph(input_file);
-    outputPageRank(iteration, graph, damping_factor, result_dir, fname);
+    outputPageRank(iteration, graph, damping_factor, result_dir, fname, options);
 
     // Clean up memory
     for (Node *node : graph->nodes)
@@ -0,0 +1,173 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <cstddef>
+#include <random>
+
+// Compressed (CSR) form of the Graph/Node structure in cpp_implementation.cpp.
+// Vertices are numbered 0..numNodes-1 in the same order sortNodes() produces
+// (by the numeric value of the label), and duplicate edges are dropped just like
+// linkChild()/linkParent() do, so rank vectors line up with getPagerankList().
+class CSRGraph
+{
+public:
+    int numNodes = 0;
+    std::vector<std::string> names;
+
+    // parents of v are inEdges[inOffsets[v] .. inOffsets[v + 1])
+    std::vector<std::size_t> inOffsets;
+    std::vector<int> inEdges;
+
+    // children of v are outEdges[outOffsets[v] .. outOffsets[v + 1])
+    std::vector<std::size_t> outOffsets;
+    std::vector<int> outEdges;
+
+    std::size_t numEdges() const { return inEdges.size(); }
+    int inDegree(int v) const { return (int)(inOffsets[v + 1] - inOffsets[v]); }
+    int outDegree(int v) const { return (int)(outOffsets[v + 1] - outOffsets[v]); }
+};
+
+// Build one direction of the adjacency from (from, to) pairs
+inline void buildAdjacency(int n, const std::vector<std::pair<int, int>> &edges,
+                           std::vector<std::size_t> &offsets, std::vector<int> &targets)
+{
+    offsets.assign(n + 1, 0);
+    for (const auto &e : edges)
+    {
+        offsets[e.first + 1]++;
+    }
+    for (int v = 0; v < n; ++v)
+    {
+        offsets[v + 1] += offsets[v];
+    }
+    targets.resize(edges.size());
+    std::vector<std::size_t> pos(offsets.begin(), offsets.end() - 1);
+    for (const auto &e : edges)
+    {
+        targets[pos[e.first]++] = e.second;
+    }
+}
+
+// edges are (parent, child) pairs over vertex ids 0..names.size()-1
+inline CSRGraph buildCSRGraph(std::vector<std::string> names, std::vector<std::pair<int, int>> edges)
+{
+    CSRGraph graph;
+    int n = (int)names.size();
+
+    // Renumber vertices in label order, same as Graph::sortNodes()
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&names](int a, int b)
+              { return std::stoi(names[a]) < std::stoi(names[b]); });
+    std::vector<int> relabel(n);
+    graph.names.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        relabel[order[i]] = i;
+        graph.names[i] = std::move(names[order[i]]);
+    }
+    for (auto &e : edges)
+    {
+        e.first = relabel[e.first];
+        e.second = relabel[e.second];
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    graph.numNodes = n;
+    buildAdjacency(n, edges, graph.outOffsets, graph.outEdges);
+    for (auto &e : edges)
+    {
+        std::swap(e.first, e.second);
+    }
+    buildAdjacency(n, edges, graph.inOffsets, graph.inEdges);
+    return graph;
+}
+
+// Drop surrounding whitespace, including the '\r' of CRLF files, as the
+// line.strip() in main_PR.py's init_graph() does
+inline void trimName(std::string &name)
+{
+    const char *space = " \t\r\n\f\v";
+    std::size_t last = name.find_last_not_of(space);
+    if (last == std::string::npos)
+    {
+        name.clear();
+        return;
+    }
+    name.erase(last + 1);
+    name.erase(0, name.find_first_not_of(space));
+}
+
+// Read the same "parent,child" edge list as initGraph(), without the linear
+// name lookups of Graph::find()
+inline CSRGraph loadCSRGraph(const std::string &fname)
+{
+    std::ifstream file(fname);
+    std::string line;
+    std::unordered_map<std::string, int> ids;
+    std::vector<std::string> names;
+    std::vector<std::pair<int, int>> edges;
+
+    auto lookup = [&ids, &names](const std::string &name)
+    {
+        auto it = ids.find(name);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        int id = (int)names.size();
+        ids.emplace(name, id);
+        names.push_back(name);
+        return id;
+    };
+
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        std::string parent, child;
+        std::getline(iss, parent, ',');
+        std::getline(iss, child, ',');
+        trimName(parent);
+        trimName(child);
+        if (parent.empty() || child.empty())
+        {
+            continue;
+        }
+        int p = lookup(parent);
+        int c = lookup(child);
+        edges.emplace_back(p, c);
+    }
+
+    return buildCSRGraph(std::move(names), std::move(edges));
+}
+
+// Uniform random graph with about n * avgDegree edges, labelled "0".."n-1",
+// for benchmarks that need something bigger than the sample dataset
+inline CSRGraph randomCSRGraph(int n, int avgDegree, unsigned seed = 1)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    std::vector<std::string> names(n);
+    for (int v = 0; v < n; ++v)
+    {
+        names[v] = std::to_string(v);
+    }
+    std::vector<std::pair<int, int>> edges((std::size_t)n * avgDegree);
+    for (auto &e : edges)
+    {
+        e = std::make_pair(pick(rng), pick(rng));
+    }
+    return buildCSRGraph(std::move(names), std::move(edges));
+}
+
+#endif
@@ -0,0 +1,465 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "csr_graph.h"
+#include "transport.h"
+#include "rank_output.h"
+
+// Multi-process PageRank. The graph is split into numParts partitions, one
+// forked worker process per partition. Every iteration each worker adds up the
+// rank contributions its vertices make to vertices owned by another worker
+// (one value per remote target vertex, not one per edge), ships them over the
+// transport on a background thread and meanwhile accumulates the contributions
+// that stay inside the partition.
+//
+// All vertices are updated from the previous iteration's ranks (Jacobi style).
+// pageRankOneIter() in cpp_implementation.cpp updates in place, and because
+// each sweep is renormalized by its sum, graphs with dangling vertices make the
+// two settle on different vectors: the results differ, however many iterations
+// are run. The ranks are therefore written to result/<name>_PageRank_distributed
+// rather than over the file cpp_implementation.cpp writes.
+
+class Partition
+{
+public:
+    int numParts = 1;
+    std::vector<int> owner;                // global vertex -> partition
+    std::vector<int> localId;              // global vertex -> index inside its partition
+    std::vector<std::vector<int>> members; // partition -> global vertices, in localId order
+
+    void finalize(const CSRGraph &graph)
+    {
+        members.assign(numParts, std::vector<int>());
+        localId.resize(graph.numNodes);
+        for (int v = 0; v < graph.numNodes; ++v)
+        {
+            localId[v] = (int)members[owner[v]].size();
+            members[owner[v]].push_back(v);
+        }
+    }
+};
+
+Partition hashPartition(const CSRGraph &graph, int parts)
+{
+    Partition partition;
+    partition.numParts = parts;
+    partition.owner.resize(graph.numNodes);
+    for (int v = 0; v < graph.numNodes; ++v)
+    {
+        uint32_t h = (uint32_t)v * 2654435761u;
+        partition.owner[v] = (int)(h % (uint32_t)parts);
+    }
+    partition.finalize(graph);
+    return partition;
+}
+
+// Linear deterministic greedy streaming partitioner: put each vertex where most
+// of its already placed neighbours are, penalised by how full that partition is.
+Partition edgeCutPartition(const CSRGraph &graph, int parts)
+{
+    Partition partition;
+    partition.numParts = parts;
+    partition.owner.assign(graph.numNodes, -1);
+    double capacity = (double)graph.numNodes / parts + 1.0;
+    std::vector<int> load(parts, 0);
+    std::vector<int> neighbours(parts, 0);
+
+    for (int v = 0; v < graph.numNodes; ++v)
+    {
+        std::fill(neighbours.begin(), neighbours.end(), 0);
+        for (std::size_t e = graph.inOffsets[v]; e < graph.inOffsets[v + 1]; ++e)
+        {
+            int u = graph.inEdges[e];
+            if (partition.owner[u] >= 0)
+            {
+                neighbours[partition.owner[u]]++;
+            }
+        }
+        for (std::size_t e = graph.outOffsets[v]; e < graph.outOffsets[v + 1]; ++e)
+        {
+            int u = graph.outEdges[e];
+            if (partition.owner[u] >= 0)
+            {
+                neighbours[partition.owner[u]]++;
+            }
+        }
+
+        int best = 0;
+        double bestScore = -1.0;
+        for (int p = 0; p < parts; ++p)
+        {
+            double score = (neighbours[p] + 1.0) * (1.0 - load[p] / capacity);
+            if (score > bestScore || (score == bestScore && load[p] < load[best]))
+            {
+                best = p;
+                bestScore = score;
+            }
+        }
+        partition.owner[v] = best;
+        load[best]++;
+    }
+    partition.finalize(graph);
+    return partition;
+}
+
+template <typename T>
+std::vector<char> packArray(const std::vector<T> &values)
+{
+    std::vector<char> buf(values.size() * sizeof(T));
+    if (!values.empty())
+    {
+        std::memcpy(buf.data(), values.data(), buf.size());
+    }
+    return buf;
+}
+
+template <typename T>
+std::vector<T> unpackArray(const std::vector<char> &buf)
+{
+    std::vector<T> values(buf.size() / sizeof(T));
+    if (!values.empty())
+    {
+        std::memcpy(values.data(), buf.data(), buf.size());
+    }
+    return values;
+}
+
+// The part of the graph one worker needs, in local vertex ids
+class PartitionWorker
+{
+public:
+    PartitionWorker(const CSRGraph &graph, const Partition &partition, Transport *transport)
+        : transport(transport), numNodes(graph.numNodes)
+    {
+        int me = transport->rank();
+        int parts = partition.numParts;
+        const std::vector<int> &mine = partition.members[me];
+        numLocal = (int)mine.size();
+
+        outDegree.resize(numLocal);
+        localOffsets.assign(numLocal + 1, 0);
+        for (int i = 0; i < numLocal; ++i)
+        {
+            int v = mine[i];
+            outDegree[i] = graph.outDegree(v);
+            for (std::size_t e = graph.inOffsets[v]; e < graph.inOffsets[v + 1]; ++e)
+            {
+                int u = graph.inEdges[e];
+                if (partition.owner[u] == me)
+                {
+                    localSources.push_back(partition.localId[u]);
+                }
+            }
+            localOffsets[i + 1] = localSources.size();
+        }
+
+        // Boundary edges grouped by (destination partition, remote target)
+        std::vector<std::vector<std::pair<int, int>>> boundary(parts);
+        for (int i = 0; i < numLocal; ++i)
+        {
+            int v = mine[i];
+            for (std::size_t e = graph.outOffsets[v]; e < graph.outOffsets[v + 1]; ++e)
+            {
+                int t = graph.outEdges[e];
+                int q = partition.owner[t];
+                if (q != me)
+                {
+                    boundary[q].emplace_back(partition.localId[t], i);
+                }
+            }
+        }
+
+        sendTargets.resize(parts);
+        sendOffsets.resize(parts);
+        sendSources.resize(parts);
+        std::vector<std::vector<char>> send(parts), recv;
+        for (int q = 0; q < parts; ++q)
+        {
+            std::sort(boundary[q].begin(), boundary[q].end());
+            sendOffsets[q].push_back(0);
+            for (std::size_t k = 0; k < boundary[q].size(); ++k)
+            {
+                if (k == 0 || boundary[q][k].first != boundary[q][k - 1].first)
+                {
+                    if (k > 0)
+                    {
+                        sendOffsets[q].push_back(sendSources[q].size());
+                    }
+                    sendTargets[q].push_back(boundary[q][k].first);
+                }
+                sendSources[q].push_back(boundary[q][k].second);
+            }
+            if (!boundary[q].empty())
+            {
+                sendOffsets[q].push_back(sendSources[q].size());
+            }
+            send[q] = packArray(sendTargets[q]);
+        }
+
+        // Tell every peer which of its vertices our per-iteration values are for
+        transport->exchange(send, recv);
+        recvTargets.resize(parts);
+        for (int q = 0; q < parts; ++q)
+        {
+            if (q != me)
+            {
+                recvTargets[q] = unpackArray<int>(recv[q]);
+            }
+        }
+
+        pagerank.assign(numLocal, 1.0);
+        contribution.resize(numLocal);
+        sums.resize(numLocal);
+    }
+
+    void pageRankOneIter(double d)
+    {
+        int me = transport->rank();
+        int parts = transport->size();
+
+        for (int i = 0; i < numLocal; ++i)
+        {
+            contribution[i] = outDegree[i] > 0 ? pagerank[i] / outDegree[i] : 0.0;
+        }
+
+        // Aggregate per destination and start the exchange
+        std::vector<std::vector<char>> send(parts), recv;
+        for (int q = 0; q < parts; ++q)
+        {
+            if (q == me)
+            {
+                continue;
+            }
+            std::vector<double> values(sendTargets[q].size());
+            for (std::size_t k = 0; k < values.size(); ++k)
+            {
+                double sum = 0.0;
+                for (std::size_t e = sendOffsets[q][k]; e < sendOffsets[q][k + 1]; ++e)
+                {
+                    sum += contribution[sendSources[q][e]];
+                }
+                values[k] = sum;
+            }
+            send[q] = packArray(values);
+        }
+        std::thread comm([this, &send, &recv]
+                         { transport->exchange(send, recv); });
+
+        // Partition-internal edges while the boundary values are in flight
+        for (int i = 0; i < numLocal; ++i)
+        {
+            double sum = 0.0;
+            for (std::size_t e = localOffsets[i]; e < localOffsets[i + 1]; ++e)
+            {
+                sum += contribution[localSources[e]];
+            }
+            sums[i] = sum;
+        }
+
+        comm.join();
+        for (int q = 0; q < parts; ++q)
+        {
+            if (q == me)
+            {
+                continue;
+            }
+            std::vector<double> values = unpackArray<double>(recv[q]);
+            for (std::size_t k = 0; k < values.size(); ++k)
+            {
+                sums[recvTargets[q][k]] += values[k];
+            }
+        }
+
+        double randomJumping = d / numNodes;
+        double localSum = 0.0;
+        for (int i = 0; i < numLocal; ++i)
+        {
+            pagerank[i] = randomJumping + (1 - d) * sums[i];
+            localSum += pagerank[i];
+        }
+
+        double pagerankSum = transport->allreduceSum(localSum);
+        for (int i = 0; i < numLocal; ++i)
+        {
+            pagerank[i] /= pagerankSum;
+        }
+    }
+
+    void pageRank(double d, int iteration)
+    {
+        for (int i = 0; i < iteration; ++i)
+        {
+            pageRankOneIter(d);
+        }
+    }
+
+    // Collect every partition's ranks on process 0, in global vertex order.
+    // Returns an empty vector on the other processes.
+    std::vector<double> gatherPagerank(const Partition &partition)
+    {
+        int parts = transport->size();
+        std::vector<std::vector<char>> send(parts), recv;
+        send[0] = packArray(pagerank);
+        transport->exchange(send, recv);
+
+        std::vector<double> pagerankList;
+        if (transport->rank() == 0)
+        {
+            pagerankList.resize(numNodes);
+            for (int q = 0; q < parts; ++q)
+            {
+                std::vector<double> values = unpackArray<double>(recv[q]);
+                for (std::size_t k = 0; k < values.size(); ++k)
+                {
+                    pagerankList[partition.members[q][k]] = values[k];
+                }
+            }
+        }
+        return pagerankList;
+    }
+
+private:
+    Transport *transport;
+    int numNodes;
+    int numLocal = 0;
+
+    std::vector<int> outDegree;
+    std::vector<std::size_t> localOffsets;
+    std::vector<int> localSources;
+
+    // per destination partition: remote targets, and for each target the local
+    // sources feeding it (sendSources[q][sendOffsets[q][k] .. sendOffsets[q][k + 1]])
+    std::vector<std::vector<int>> sendTargets;
+    std::vector<std::vector<std::size_t>> sendOffsets;
+    std::vector<std::vector<int>> sendSources;
+    // per source partition: local ids of the values it sends us, in order
+    std::vector<std::vector<int>> recvTargets;
+
+    std::vector<double> pagerank;
+    std::vector<double> contribution;
+    std::vector<double> sums;
+};
+
+// Terminate and reap the workers forked so far
+void stopWorkers(const std::vector<pid_t> &children)
+{
+    for (pid_t pid : children)
+    {
+        kill(pid, SIGTERM);
+    }
+    for (pid_t pid : children)
+    {
+        waitpid(pid, nullptr, 0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string input_file = argc > 1 ? argv[1] : "dataset/graph_1.txt";
+    int num_procs = argc > 2 ? std::atoi(argv[2]) : 2;
+    std::string partitioner = argc > 3 ? argv[3] : "hash";
+    std::string transport_kind = argc > 4 ? argv[4] : "socket";
+    int iteration = argc > 5 ? std::atoi(argv[5]) : 500;
+    double damping_factor = 0.15;
+    RankOutputOptions options;
+    options.topK = argc > 6 ? std::atoi(argv[6]) : 0;
+    if (argc > 7 && !parseRankFormat(argv[7], options.format))
+    {
+        std::cerr << "unknown format " << argv[7] << " (expected text, bin32, bin64 or none)" << std::endl;
+        return 1;
+    }
+
+    std::string result_dir = "result";
+    std::string fname = input_file.substr(input_file.find_last_of("/") + 1, input_file.find_last_of(".") - input_file.find_last_of("/") - 1);
+
+    if (num_procs < 1)
+    {
+        std::cerr << "number of processes must be at least 1" << std::endl;
+        return 1;
+    }
+    if (partitioner != "hash" && partitioner != "edgecut")
+    {
+        std::cerr << "unknown partitioner '" << partitioner << "' (expected hash or edgecut)" << std::endl;
+        return 1;
+    }
+
+    CSRGraph graph = loadCSRGraph(input_file);
+    Partition partition = partitioner == "hash" ? hashPartition(graph, num_procs) : edgeCutPartition(graph, num_procs);
+    std::unique_ptr<Transport> transport;
+    try
+    {
+        transport.reset(createTransport(transport_kind, num_procs));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<pid_t> children;
+    for (int rank = 0; rank < num_procs; ++rank)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            std::cerr << "fork failed" << std::endl;
+            stopWorkers(children);
+            return 1;
+        }
+        if (pid == 0)
+        {
+            int status = 0;
+            try
+            {
+                transport->attach(rank);
+                PartitionWorker worker(graph, partition, transport.get());
+                worker.pageRank(damping_factor, iteration);
+                std::vector<double> pagerank_list = worker.gatherPagerank(partition);
+                if (rank == 0)
+                {
+                    writeRanks(pagerank_list, graph.names, "PageRank", result_dir + "/" + fname + "_PageRank_distributed", options);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "worker " << rank << ": " << e.what() << std::endl;
+                status = 1;
+            }
+            std::cout.flush();
+            _exit(status);
+        }
+        children.push_back(pid);
+    }
+
+    // A worker that dies leaves its peers waiting on the exchange, so take the
+    // rest down with it
+    int failed = 0;
+    for (std::size_t remaining = children.size(); remaining > 0; --remaining)
+    {
+        int status = 0;
+        if (wait(&status) < 0)
+        {
+            break;
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            if (failed++ == 0)
+            {
+                for (pid_t pid : children)
+                {
+                    kill(pid, SIGTERM);
+                }
+            }
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
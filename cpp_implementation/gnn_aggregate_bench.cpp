@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+#include "csr_graph.h"
+#include "gnn_aggregate.h"
+
+// Neighbourhood aggregation throughput across feature widths.
+// Aggregation counts one flop per edge per feature column; the fused layer adds
+// 2 * cols * outCols flops per vertex for the weight multiply.
+
+FeatureMatrix randomFeatures(int rows, int cols, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    FeatureMatrix m(rows, cols);
+    for (float &x : m.data)
+    {
+        x = dist(rng);
+    }
+    return m;
+}
+
+template <typename F>
+double bestSeconds(int repeat, F &&run)
+{
+    double best = 1e30;
+    for (int r = 0; r < repeat; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    int num_nodes = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int avg_degree = argc > 2 ? std::atoi(argv[2]) : 16;
+    int repeat = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    CSRGraph graph = randomCSRGraph(num_nodes, avg_degree);
+    std::cout << "nodes " << graph.numNodes << " edges " << graph.numEdges() << std::endl;
+    std::cout << std::setw(6) << "F" << std::setw(10) << "sum" << std::setw(10) << "mean" << std::setw(10) << "max"
+              << std::setw(12) << "fused-mean" << "   (GFLOP/s, F' = F)" << std::endl;
+
+    for (int cols : {16, 32, 64, 128, 256})
+    {
+        FeatureMatrix features = randomFeatures(graph.numNodes, cols, 1);
+        FeatureMatrix weight = randomFeatures(cols, cols, 2);
+        std::vector<float> bias(cols, 0.1f);
+        FeatureMatrix out;
+
+        double aggregateFlops = (double)graph.numEdges() * cols;
+        double fusedFlops = ((double)graph.numEdges() + graph.numNodes) * cols + 2.0 * graph.numNodes * cols * cols;
+
+        std::cout << std::setw(6) << cols << std::fixed << std::setprecision(2);
+        for (Aggregation a : {Aggregation::Sum, Aggregation::Mean, Aggregation::Max})
+        {
+            double t = bestSeconds(repeat, [&]
+                                   { aggregateNeighbors(graph, features, out, a); });
+            std::cout << std::setw(10) << aggregateFlops / t * 1e-9;
+        }
+        double t = bestSeconds(repeat, [&]
+                               { aggregateTransform(graph, features, weight, bias, out, Aggregation::Mean); });
+        std::cout << std::setw(12) << fusedFlops / t * 1e-9 << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "csr_graph.h"
+#include "link_analysis.h"
+#include "rank_output.h"
+
+// Runs one of the link analysis algorithms of link_analysis.h on an edge list
+// and writes the scores like cpp_implementation.cpp does. "pagerank" is the
+// in-place update of cpp_implementation.cpp and gives the same ranks;
+// "pagerank-sync" is the parallel synchronous update, which converges to
+// different ranks and so is written to its own _PageRank_sync file.
+
+int main(int argc, char **argv)
+{
+    std::string input_file = argc > 1 ? argv[1] : "dataset/graph_1.txt";
+    std::string algorithm = argc > 2 ? argv[2] : "pagerank";
+    int iteration = argc > 3 ? std::atoi(argv[3]) : 500;
+    double damping_factor = 0.15;
+    double katz_alpha = 0.05;
+    RankOutputOptions options;
+    options.topK = argc > 4 ? std::atoi(argv[4]) : 0;
+    if (argc > 5 && !parseRankFormat(argv[5], options.format))
+    {
+        std::cerr << "unknown format " << argv[5] << " (expected text, bin32, bin64 or none)" << std::endl;
+        return 1;
+    }
+
+    std::string result_dir = "result";
+    std::string fname = input_file.substr(input_file.find_last_of("/") + 1, input_file.find_last_of(".") - input_file.find_last_of("/") - 1);
+    std::string path = result_dir + "/" + fname;
+
+    CSRGraph graph = loadCSRGraph(input_file);
+    if (graph.numNodes == 0)
+    {
+        std::cerr << "no edges read from " << input_file << std::endl;
+        return 1;
+    }
+
+    if (algorithm == "pagerank")
+    {
+        std::vector<double> pagerank = runPageRankInPlace(graph, damping_factor, iteration);
+        writeRanks(pagerank, graph.names, "PageRank", path + "_PageRank", options);
+    }
+    else if (algorithm == "pagerank-sync")
+    {
+        std::vector<double> pagerank = runPageRank(graph, damping_factor, iteration);
+        writeRanks(pagerank, graph.names, "PageRank", path + "_PageRank_sync", options);
+    }
+    else if (algorithm == "ppr")
+    {
+        // Personalized on the first vertex
+        std::vector<double> personalization(graph.numNodes, 0.0);
+        personalization[0] = 1.0;
+        std::vector<double> pagerank = runPersonalizedPageRank(graph, damping_factor, personalization, iteration);
+        writeRanks(pagerank, graph.names, "PersonalizedPageRank", path + "_PersonalizedPageRank", options);
+    }
+    else if (algorithm == "hits")
+    {
+        std::pair<std::vector<double>, std::vector<double>> authHub = runHits(graph, iteration);
+        writeRanks(authHub.first, graph.names, "Authority", path + "_HITS_authority", options);
+        writeRanks(authHub.second, graph.names, "Hub", path + "_HITS_hub", options);
+    }
+    else if (algorithm == "katz")
+    {
+        std::vector<double> katz = runKatz(graph, katz_alpha, 1.0, iteration);
+        writeRanks(katz, graph.names, "Katz", path + "_Katz", options);
+    }
+    else
+    {
+        std::cerr << "unknown algorithm " << algorithm << " (expected pagerank, pagerank-sync, ppr, hits or katz)" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,344 @@
+#ifndef LINK_ANALYSIS_H
+#define LINK_ANALYSIS_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#include "csr_graph.h"
+
+// Generic sparse matrix-vector engine for link analysis on a CSRGraph.
+//
+// An algorithm is a policy type describing one vertex program step
+//
+//     y[v] = apply(v, combine over neighbours u of gather(u, x[u]))
+//
+// followed by an optional normalization of y. The engine is a template over the
+// policy, so every policy gets its own copy of the loops with gather/combine/
+// apply inlined; there are no virtual calls or switches in the hot loop.
+//
+// A policy provides:
+//
+//     static constexpr bool alongInEdges;                 // neighbours are parents (true) or children
+//     static constexpr Normalization normalization;
+//     static double identity();                           // of combine
+//     static double combine(double acc, double value);
+//     double gather(int u, double xu) const;              // per source vertex
+//     double apply(int v, double acc) const;              // per destination vertex
+//
+// gather() runs in a separate vertex-parallel pass before the edge pass, so it
+// is evaluated once per vertex instead of once per edge. Normalization is fused
+// too: the edge pass accumulates the norm of y and the next gather pass (or a
+// final pass after the last iteration) does the scaling.
+//
+// runVertexProgram() updates synchronously (Jacobi): every y[v] is computed
+// from the previous x. runVertexProgramInPlace() instead sweeps the vertices in
+// order and overwrites x[v] as it goes (Gauss-Seidel), which is what the Node
+// based loops in cpp_implementation.cpp and main_PR.py do. With normalization
+// after every sweep and dangling vertices the two converge to different
+// vectors, so use the in-place form to reproduce those programs.
+// Build with -O3 -fopenmp to run the synchronous passes in parallel; the
+// in-place sweep is inherently serial.
+
+enum class Normalization
+{
+    None,
+    Sum,
+    L2
+};
+
+// (+, x) semiring shared by all the policies below
+struct PlusTimes
+{
+    static double identity() { return 0.0; }
+    static double combine(double acc, double value) { return acc + value; }
+};
+
+template <Normalization N>
+inline double normTerm(double y)
+{
+    return N == Normalization::L2 ? y * y : N == Normalization::Sum ? y : 0.0;
+}
+
+template <Normalization N>
+inline double normScale(double norm)
+{
+    if (N == Normalization::None || norm == 0.0)
+    {
+        return 1.0;
+    }
+    return N == Normalization::L2 ? 1.0 / std::sqrt(norm) : 1.0 / norm;
+}
+
+// src[u] = gather(u, x[u] * scale), storing the scaled x back into x
+template <typename Policy>
+void gatherPass(const Policy &policy, int n, double scale, double *__restrict x, double *__restrict src)
+{
+#ifdef _OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+    for (int u = 0; u < n; ++u)
+    {
+        double xu = x[u] * scale;
+        x[u] = xu;
+        src[u] = policy.gather(u, xu);
+    }
+}
+
+// y[v] = apply(v, combine of src over neighbours); returns the norm of y
+template <typename Policy>
+double edgePass(const CSRGraph &graph, const Policy &policy, const double *__restrict src, double *__restrict y)
+{
+    const std::size_t *offsets = Policy::alongInEdges ? graph.inOffsets.data() : graph.outOffsets.data();
+    const int *edges = Policy::alongInEdges ? graph.inEdges.data() : graph.outEdges.data();
+    const int n = graph.numNodes;
+    double norm = 0.0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : norm)
+#endif
+    for (int v = 0; v < n; ++v)
+    {
+        double acc = Policy::identity();
+        for (std::size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+        {
+            acc = Policy::combine(acc, src[edges[e]]);
+        }
+        double yv = policy.apply(v, acc);
+        y[v] = yv;
+        norm += normTerm<Policy::normalization>(yv);
+    }
+    return norm;
+}
+
+inline void scalePass(int n, double scale, double *x)
+{
+    if (scale == 1.0)
+    {
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+    for (int v = 0; v < n; ++v)
+    {
+        x[v] *= scale;
+    }
+}
+
+// Run iteration steps of the policy starting from x, leaving the (normalized)
+// result in x
+template <typename Policy>
+void runVertexProgram(const CSRGraph &graph, const Policy &policy, std::vector<double> &x, int iteration)
+{
+    const int n = graph.numNodes;
+    if ((int)x.size() != n)
+    {
+        throw std::invalid_argument("vector needs one entry per vertex");
+    }
+    std::vector<double> src(n), y(n);
+    double scale = 1.0;
+    for (int i = 0; i < iteration; ++i)
+    {
+        gatherPass(policy, n, scale, x.data(), src.data());
+        double norm = edgePass(graph, policy, src.data(), y.data());
+        scale = normScale<Policy::normalization>(norm);
+        x.swap(y);
+    }
+    scalePass(n, scale, x.data());
+}
+
+// In-place sweeps in vertex order. gather() is evaluated per edge because x[u]
+// may already have been updated earlier in the same sweep.
+template <typename Policy>
+void runVertexProgramInPlace(const CSRGraph &graph, const Policy &policy, std::vector<double> &x, int iteration)
+{
+    const int n = graph.numNodes;
+    if ((int)x.size() != n)
+    {
+        throw std::invalid_argument("vector needs one entry per vertex");
+    }
+    const std::size_t *offsets = Policy::alongInEdges ? graph.inOffsets.data() : graph.outOffsets.data();
+    const int *edges = Policy::alongInEdges ? graph.inEdges.data() : graph.outEdges.data();
+    for (int i = 0; i < iteration; ++i)
+    {
+        double norm = 0.0;
+        for (int v = 0; v < n; ++v)
+        {
+            double acc = Policy::identity();
+            for (std::size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+            {
+                int u = edges[e];
+                acc = Policy::combine(acc, policy.gather(u, x[u]));
+            }
+            x[v] = policy.apply(v, acc);
+            norm += normTerm<Policy::normalization>(x[v]);
+        }
+        scalePass(n, normScale<Policy::normalization>(norm), x.data());
+    }
+}
+
+inline std::vector<double> inverseOutDegrees(const CSRGraph &graph)
+{
+    std::vector<double> inv(graph.numNodes);
+    for (int u = 0; u < graph.numNodes; ++u)
+    {
+        int degree = graph.outDegree(u);
+        inv[u] = degree > 0 ? 1.0 / degree : 0.0;
+    }
+    return inv;
+}
+
+// Same update as Node::updatePagerank() followed by Graph::normalizePagerank():
+// pagerank = d / n + (1 - d) * sum(parent pagerank / parent out-degree)
+class PageRankPolicy : public PlusTimes
+{
+public:
+    static constexpr bool alongInEdges = true;
+    static constexpr Normalization normalization = Normalization::Sum;
+
+    PageRankPolicy(const CSRGraph &graph, double d)
+        : invOutDegree(inverseOutDegrees(graph)), randomJumping(d / graph.numNodes), damping(1 - d) {}
+
+    double gather(int u, double xu) const { return xu * invOutDegree[u]; }
+    double apply(int, double acc) const { return randomJumping + damping * acc; }
+
+private:
+    std::vector<double> invOutDegree;
+    double randomJumping;
+    double damping;
+};
+
+// PageRank whose random jumps land on personalization[v] instead of uniformly
+class PersonalizedPageRankPolicy : public PlusTimes
+{
+public:
+    static constexpr bool alongInEdges = true;
+    static constexpr Normalization normalization = Normalization::Sum;
+
+    PersonalizedPageRankPolicy(const CSRGraph &graph, double d, const std::vector<double> &personalization)
+        : invOutDegree(inverseOutDegrees(graph)), jump(personalization), damping(1 - d)
+    {
+        if ((int)jump.size() != graph.numNodes)
+        {
+            throw std::invalid_argument("personalization needs one entry per vertex");
+        }
+        double sum = 0.0;
+        for (double p : jump)
+        {
+            sum += p;
+        }
+        if (sum <= 0.0)
+        {
+            throw std::invalid_argument("personalization must have positive mass");
+        }
+        for (double &p : jump)
+        {
+            p *= d / sum;
+        }
+    }
+
+    double gather(int u, double xu) const { return xu * invOutDegree[u]; }
+    double apply(int v, double acc) const { return jump[v] + damping * acc; }
+
+private:
+    std::vector<double> invOutDegree;
+    std::vector<double> jump;
+    double damping;
+};
+
+// HITS half steps: auth from the parents' hub scores, hub from the children's
+// auth scores, each normalized to sum 1 like Graph::normalizeAuthHub()
+class AuthPolicy : public PlusTimes
+{
+public:
+    static constexpr bool alongInEdges = true;
+    static constexpr Normalization normalization = Normalization::Sum;
+
+    double gather(int, double hub) const { return hub; }
+    double apply(int, double acc) const { return acc; }
+};
+
+class HubPolicy : public PlusTimes
+{
+public:
+    static constexpr bool alongInEdges = false;
+    static constexpr Normalization normalization = Normalization::Sum;
+
+    double gather(int, double auth) const { return auth; }
+    double apply(int, double acc) const { return acc; }
+};
+
+// Katz centrality: x[v] = alpha * sum(x[parent]) + beta. Converges for alpha
+// below 1 / (largest eigenvalue of the adjacency matrix).
+class KatzPolicy : public PlusTimes
+{
+public:
+    static constexpr bool alongInEdges = true;
+    static constexpr Normalization normalization = Normalization::None;
+
+    KatzPolicy(double alpha, double beta) : alpha(alpha), beta(beta) {}
+
+    double gather(int, double xu) const { return xu; }
+    double apply(int, double acc) const { return alpha * acc + beta; }
+
+private:
+    double alpha;
+    double beta;
+};
+
+inline std::vector<double> runPageRank(const CSRGraph &graph, double d, int iteration = 100)
+{
+    std::vector<double> pagerank(graph.numNodes, 1.0);
+    runVertexProgram(graph, PageRankPolicy(graph, d), pagerank, iteration);
+    return pagerank;
+}
+
+// Same ranks as pageRank() in cpp_implementation.cpp and PageRank() in main_PR.py
+inline std::vector<double> runPageRankInPlace(const CSRGraph &graph, double d, int iteration = 100)
+{
+    std::vector<double> pagerank(graph.numNodes, 1.0);
+    runVertexProgramInPlace(graph, PageRankPolicy(graph, d), pagerank, iteration);
+    return pagerank;
+}
+
+inline std::vector<double> runPersonalizedPageRank(const CSRGraph &graph, double d,
+                                                   const std::vector<double> &personalization, int iteration = 100)
+{
+    std::vector<double> pagerank(graph.numNodes, 1.0);
+    runVertexProgram(graph, PersonalizedPageRankPolicy(graph, d, personalization), pagerank, iteration);
+    return pagerank;
+}
+
+// Returns (auth, hub). Each iteration updates auth from hub, then hub from the
+// new auth; each half step normalizes the vector it reads on the fly.
+inline std::pair<std::vector<double>, std::vector<double>> runHits(const CSRGraph &graph, int iteration = 100)
+{
+    const int n = graph.numNodes;
+    std::vector<double> auth(n, 1.0);
+    std::vector<double> hub(n, 1.0);
+    std::vector<double> src(n);
+    AuthPolicy authPolicy;
+    HubPolicy hubPolicy;
+    double hubScale = 1.0;
+    for (int i = 0; i < iteration; ++i)
+    {
+        gatherPass(authPolicy, n, hubScale, hub.data(), src.data());
+        double authScale = normScale<AuthPolicy::normalization>(edgePass(graph, authPolicy, src.data(), auth.data()));
+        gatherPass(hubPolicy, n, authScale, auth.data(), src.data());
+        hubScale = normScale<HubPolicy::normalization>(edgePass(graph, hubPolicy, src.data(), hub.data()));
+    }
+    scalePass(n, hubScale, hub.data());
+    return std::make_pair(std::move(auth), std::move(hub));
+}
+
+inline std::vector<double> runKatz(const CSRGraph &graph, double alpha, double beta = 1.0, int iteration = 100)
+{
+    std::vector<double> katz(graph.numNodes, 0.0);
+    runVertexProgram(graph, KatzPolicy(alpha, beta), katz, iteration);
+    return katz;
+}
+
+#endif
@@ -0,0 +1,292 @@
+#ifndef NEIGHBOR_SAMPLER_H
+#define NEIGHBOR_SAMPLER_H
+
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#include "csr_graph.h"
+#include "gnn_aggregate.h"
+
+// GraphSAGE style mini-batch sampling. For a batch of seed vertices, hop h
+// draws up to fanouts[h] distinct parents (in-neighbours) of every vertex in the
+// current frontier, so a batch covers fanouts.size() hops.
+//
+// A batch is a stack of blocks, one per GNN layer, in the order the layers are
+// applied: blocks.front() reads the gathered input features and blocks.back()
+// produces the seed outputs. Each block is a CSRGraph holding only the
+// in-adjacency, over local ids. Its numNodes destination vertices are local ids
+// 0..numNodes-1 of its source list and its sources are the destination vertices
+// of the block before it (or inputNodes for the first block), so the output of
+// one layer is directly the feature matrix of the next, as aggregateTransform()
+// in gnn_aggregate.h expects.
+
+class MiniBatch
+{
+public:
+    long long index = -1;        // position of the batch within the epoch
+    std::vector<int> seeds;      // global ids of the output vertices
+    std::vector<int> inputNodes; // global ids of every vertex read, seeds first
+    std::vector<CSRGraph> blocks;
+    FeatureMatrix features; // features of inputNodes, one row each
+};
+
+// SplitMix64. Every sampling decision gets its own stream derived from
+// (seed, epoch, batch, hop, vertex) so results do not depend on which thread,
+// or how many threads, did the work.
+class SampleRng
+{
+public:
+    explicit SampleRng(uint64_t seed) : state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound)
+    uint32_t below(uint32_t bound) { return (uint32_t)(((next() >> 32) * bound) >> 32); }
+
+    static uint64_t mix(uint64_t a, uint64_t b)
+    {
+        SampleRng rng(a ^ (b * 0xd6e8feb86659fd93ull));
+        return rng.next();
+    }
+
+private:
+    uint64_t state;
+};
+
+class NeighborSampler
+{
+public:
+    // numWorkers background threads build up to prefetch batches ahead of the
+    // one being consumed
+    NeighborSampler(const CSRGraph &graph, const FeatureMatrix &features, std::vector<int> fanouts, int batchSize,
+                    int numWorkers = 2, int prefetch = 4, uint64_t seed = 1)
+        : graph(graph), features(features), fanouts(std::move(fanouts)), batchSize(batchSize),
+          numWorkers(std::max(1, numWorkers)), prefetch(std::max(1, prefetch)), seed(seed)
+    {
+        if (features.rows != graph.numNodes)
+        {
+            throw std::invalid_argument("feature matrix needs one row per vertex");
+        }
+        if (batchSize < 1)
+        {
+            throw std::invalid_argument("batch size must be positive");
+        }
+    }
+
+    ~NeighborSampler()
+    {
+        stop();
+    }
+
+    // Start sampling batches over seedNodes, shuffled with the epoch number
+    void startEpoch(std::vector<int> seedNodes, int epoch = 0, bool shuffle = true)
+    {
+        stop();
+        if (shuffle)
+        {
+            std::mt19937_64 rng(SampleRng::mix(seed, (uint64_t)epoch));
+            std::shuffle(seedNodes.begin(), seedNodes.end(), rng);
+        }
+        epochSeeds = std::move(seedNodes);
+        epochNumber = epoch;
+        numBatches = ((long long)epochSeeds.size() + batchSize - 1) / batchSize;
+        nextToBuild = 0;
+        nextToDeliver = 0;
+        ready.clear();
+        stopping = false;
+        for (int w = 0; w < numWorkers; ++w)
+        {
+            workers.emplace_back([this]
+                                 { workerLoop(); });
+        }
+    }
+
+    // Hand out the next batch in order; false once the epoch is exhausted
+    bool next(MiniBatch &batch)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (nextToDeliver >= numBatches)
+        {
+            return false;
+        }
+        delivered.wait(lock, [this]
+                       { return ready.count(nextToDeliver) > 0; });
+        auto it = ready.find(nextToDeliver);
+        batch = std::move(it->second);
+        ready.erase(it);
+        nextToDeliver++;
+        lock.unlock();
+        progress.notify_all();
+        return true;
+    }
+
+    long long batchesPerEpoch() const { return numBatches; }
+
+    // Build one batch on the calling thread; scratch must hold graph.numNodes
+    // entries set to -1 and is left that way
+    void sampleBatch(long long index, MiniBatch &batch, std::vector<int> &scratch) const
+    {
+        std::size_t begin = (std::size_t)index * batchSize;
+        std::size_t end = std::min(epochSeeds.size(), begin + batchSize);
+        batch.index = index;
+        batch.seeds.assign(epochSeeds.begin() + begin, epochSeeds.begin() + end);
+        batch.blocks.assign(fanouts.size(), CSRGraph());
+
+        // frontier doubles as the source list under construction; scratch maps
+        // global ids already in it to their local id
+        std::vector<int> frontier = batch.seeds;
+        for (std::size_t i = 0; i < frontier.size(); ++i)
+        {
+            scratch[frontier[i]] = (int)i;
+        }
+
+        for (std::size_t hop = 0; hop < fanouts.size(); ++hop)
+        {
+            CSRGraph &block = batch.blocks[fanouts.size() - 1 - hop];
+            int numDst = (int)frontier.size();
+            int fanout = fanouts[hop];
+            uint64_t hopSeed = SampleRng::mix(SampleRng::mix(seed, (uint64_t)epochNumber),
+                                              (uint64_t)index * 64 + hop);
+
+            block.numNodes = numDst;
+            block.inOffsets.assign(numDst + 1, 0);
+            for (int i = 0; i < numDst; ++i)
+            {
+                int degree = graph.inDegree(frontier[i]);
+                block.inOffsets[i + 1] = block.inOffsets[i] + std::min(degree, fanout);
+            }
+            block.inEdges.resize(block.inOffsets[numDst]);
+
+            for (int i = 0; i < numDst; ++i)
+            {
+                int v = frontier[i];
+                int *out = block.inEdges.data() + block.inOffsets[i];
+                int count = (int)(block.inOffsets[i + 1] - block.inOffsets[i]);
+                const int *parents = graph.inEdges.data() + graph.inOffsets[v];
+                int degree = graph.inDegree(v);
+
+                if (count == degree)
+                {
+                    std::copy(parents, parents + degree, out);
+                }
+                else
+                {
+                    // Floyd's algorithm: count distinct positions out of degree
+                    SampleRng rng(SampleRng::mix(hopSeed, (uint64_t)v));
+                    for (int j = degree - count, k = 0; j < degree; ++j, ++k)
+                    {
+                        int t = (int)rng.below((uint32_t)j + 1);
+                        int pick = std::find(out, out + k, parents[t]) == out + k ? t : j;
+                        out[k] = parents[pick];
+                    }
+                }
+
+                // Relabel into the source list, appending vertices seen for the first time
+                for (int k = 0; k < count; ++k)
+                {
+                    int u = out[k];
+                    if (scratch[u] < 0)
+                    {
+                        scratch[u] = (int)frontier.size();
+                        frontier.push_back(u);
+                    }
+                    out[k] = scratch[u];
+                }
+            }
+        }
+
+        batch.inputNodes = std::move(frontier);
+        for (int u : batch.inputNodes)
+        {
+            scratch[u] = -1;
+        }
+
+        int cols = features.cols;
+        batch.features = FeatureMatrix((int)batch.inputNodes.size(), cols);
+        for (std::size_t i = 0; i < batch.inputNodes.size(); ++i)
+        {
+            std::memcpy(batch.features.row((int)i), features.row(batch.inputNodes[i]), sizeof(float) * cols);
+        }
+    }
+
+private:
+    const CSRGraph &graph;
+    const FeatureMatrix &features;
+    std::vector<int> fanouts;
+    int batchSize;
+    int numWorkers;
+    int prefetch;
+    uint64_t seed;
+
+    std::vector<int> epochSeeds;
+    int epochNumber = 0;
+    long long numBatches = 0;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable progress;  // a batch was consumed, or stop()
+    std::condition_variable delivered; // a batch was finished
+    long long nextToBuild = 0;
+    long long nextToDeliver = 0;
+    std::map<long long, MiniBatch> ready;
+    bool stopping = false;
+
+    void workerLoop()
+    {
+        std::vector<int> scratch(graph.numNodes, -1);
+        for (;;)
+        {
+            long long index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                progress.wait(lock, [this]
+                              { return stopping || nextToBuild >= numBatches || nextToBuild < nextToDeliver + prefetch; });
+                if (stopping || nextToBuild >= numBatches)
+                {
+                    return;
+                }
+                index = nextToBuild++;
+            }
+
+            MiniBatch batch;
+            sampleBatch(index, batch, scratch);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready.emplace(index, std::move(batch));
+            }
+            delivered.notify_all();
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        progress.notify_all();
+        for (std::thread &t : workers)
+        {
+            t.join();
+        }
+        workers.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+#include "csr_graph.h"
+#include "gnn_aggregate.h"
+#include "neighbor_sampler.h"
+
+// Two-layer GraphSAGE-style forward pass over sampled mini-batches. Reports how
+// long the compute loop spent waiting in NeighborSampler::next(); with enough
+// sampling workers that should be close to zero.
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+FeatureMatrix randomFeatures(int rows, int cols, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    FeatureMatrix m(rows, cols);
+    for (float &x : m.data)
+    {
+        x = dist(rng);
+    }
+    return m;
+}
+
+int main(int argc, char **argv)
+{
+    int num_nodes = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int avg_degree = argc > 2 ? std::atoi(argv[2]) : 16;
+    int batch_size = argc > 3 ? std::atoi(argv[3]) : 512;
+    int num_workers = argc > 4 ? std::atoi(argv[4]) : 2;
+    int cols = 64;
+    std::vector<int> fanouts = {10, 5}; // hop from the seeds first
+
+    CSRGraph graph = randomCSRGraph(num_nodes, avg_degree);
+    FeatureMatrix features = randomFeatures(graph.numNodes, cols, 1);
+    std::vector<FeatureMatrix> weights = {randomFeatures(cols, cols, 2), randomFeatures(cols, cols, 3)};
+    std::vector<float> bias;
+
+    std::vector<int> seeds(graph.numNodes);
+    std::iota(seeds.begin(), seeds.end(), 0);
+
+    NeighborSampler sampler(graph, features, fanouts, batch_size, num_workers);
+    sampler.startEpoch(seeds, 0);
+
+    MiniBatch batch;
+    FeatureMatrix hidden[2];
+    double waiting = 0.0;
+    long long sampled_edges = 0;
+    double checksum = 0.0;
+    auto start = Clock::now();
+    for (;;)
+    {
+        auto wait_start = Clock::now();
+        if (!sampler.next(batch))
+        {
+            break;
+        }
+        waiting += secondsSince(wait_start);
+
+        const FeatureMatrix *input = &batch.features;
+        for (std::size_t layer = 0; layer < batch.blocks.size(); ++layer)
+        {
+            aggregateTransform(batch.blocks[layer], *input, weights[layer], bias, hidden[layer % 2], Aggregation::Mean);
+            input = &hidden[layer % 2];
+            sampled_edges += (long long)batch.blocks[layer].numEdges();
+        }
+        checksum += input->data[0];
+    }
+    double total = secondsSince(start);
+
+    std::cout << "nodes " << graph.numNodes << " edges " << graph.numEdges() << " batches " << sampler.batchesPerEpoch()
+              << " sampled edges " << sampled_edges << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "epoch " << total << " s, waiting for batches " << waiting
+              << " s (" << 100.0 * waiting / total << "%), checksum " << checksum << std::endl;
+    return 0;
+}
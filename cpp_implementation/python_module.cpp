@@ -0,0 +1,567 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <string>
+#include <fstream>
+#include <cerrno>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <new>
+
+#include "csr_graph.h"
+#include "link_analysis.h"
+
+// Python extension module "gnncpu" exposing csr_graph.h and link_analysis.h
+// to main_PR.py. Built by setup.py at the top of the repository.
+//
+// Arrays are returned without copying: a NativeArray owns (or borrows from its
+// Graph) the engine's memory and exports it through the buffer protocol, and
+// when NumPy is installed the functions hand back numpy.asarray() views of
+// it. The GIL is released while the engine runs, so other Python threads keep
+// going and the OpenMP threads are not serialized behind the interpreter.
+
+// --- NativeArray ------------------------------------------------------------
+
+typedef struct
+{
+    PyObject_HEAD
+    std::vector<double> *owned; // ranks produced by the engine, or nullptr
+    PyObject *base;             // object that owns data when owned is nullptr
+    void *data;
+    Py_ssize_t length;
+    Py_ssize_t itemsize;
+    const char *format;
+} NativeArray;
+
+static void NativeArray_dealloc(NativeArray *self)
+{
+    delete self->owned;
+    Py_XDECREF(self->base);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+// Results are writable; views into a Graph are read-only
+static int NativeArray_getbuffer(NativeArray *self, Py_buffer *view, int flags)
+{
+    bool readonly = self->owned == nullptr;
+    if (readonly && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "graph arrays are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    Py_INCREF(self);
+    view->obj = (PyObject *)self;
+    view->buf = self->data;
+    view->len = self->length * self->itemsize;
+    view->readonly = readonly;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? (char *)self->format : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &self->length : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &self->itemsize : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static Py_ssize_t NativeArray_length(NativeArray *self)
+{
+    return self->length;
+}
+
+static PyBufferProcs NativeArray_as_buffer = {
+    (getbufferproc)NativeArray_getbuffer,
+    nullptr,
+};
+
+static PySequenceMethods NativeArray_as_sequence = {
+    (lenfunc)NativeArray_length,
+};
+
+static PyTypeObject NativeArrayType = {
+    PyVarObject_HEAD_INIT(nullptr, 0)
+    "gnncpu.NativeArray",
+};
+
+// Wrap an engine result, taking ownership of its storage
+static PyObject *wrapVector(std::vector<double> &&values)
+{
+    NativeArray *self = PyObject_New(NativeArray, &NativeArrayType);
+    if (self == nullptr)
+    {
+        return nullptr;
+    }
+    self->owned = new std::vector<double>(std::move(values));
+    self->base = nullptr;
+    self->data = self->owned->data();
+    self->length = (Py_ssize_t)self->owned->size();
+    self->itemsize = sizeof(double);
+    self->format = "d";
+    return (PyObject *)self;
+}
+
+// View into memory owned by base, which is kept alive by the view
+static PyObject *wrapBorrowed(PyObject *base, const void *data, std::size_t length, std::size_t itemsize,
+                              const char *format)
+{
+    NativeArray *self = PyObject_New(NativeArray, &NativeArrayType);
+    if (self == nullptr)
+    {
+        return nullptr;
+    }
+    self->owned = nullptr;
+    Py_INCREF(base);
+    self->base = base;
+    self->data = (void *)data;
+    self->length = (Py_ssize_t)length;
+    self->itemsize = (Py_ssize_t)itemsize;
+    self->format = format;
+    return (PyObject *)self;
+}
+
+// numpy.asarray(array), a view through the buffer protocol, if NumPy is
+// available; the NativeArray itself otherwise
+static PyObject *toNumpy(PyObject *array)
+{
+    if (array == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *numpy = PyImport_ImportModule("numpy");
+    if (numpy == nullptr)
+    {
+        PyErr_Clear();
+        return array;
+    }
+    PyObject *view = PyObject_CallMethod(numpy, "asarray", "O", array);
+    Py_DECREF(numpy);
+    Py_DECREF(array);
+    return view;
+}
+
+// --- Graph --------------------------------------------------------------------
+
+typedef struct
+{
+    PyObject_HEAD
+    CSRGraph *graph;
+} PyCSRGraph;
+
+static void PyCSRGraph_dealloc(PyCSRGraph *self)
+{
+    delete self->graph;
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *PyCSRGraph_num_nodes(PyCSRGraph *self, void *)
+{
+    return PyLong_FromLong(self->graph->numNodes);
+}
+
+static PyObject *PyCSRGraph_num_edges(PyCSRGraph *self, void *)
+{
+    return PyLong_FromSize_t(self->graph->numEdges());
+}
+
+static PyObject *PyCSRGraph_names(PyCSRGraph *self, void *)
+{
+    const std::vector<std::string> &names = self->graph->names;
+    PyObject *list = PyList_New((Py_ssize_t)names.size());
+    if (list == nullptr)
+    {
+        return nullptr;
+    }
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        PyObject *name = PyUnicode_FromStringAndSize(names[i].data(), (Py_ssize_t)names[i].size());
+        if (name == nullptr)
+        {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, name);
+    }
+    return list;
+}
+
+static_assert(sizeof(std::size_t) == 8, "offset arrays are exported as uint64");
+
+static PyObject *PyCSRGraph_in_offsets(PyCSRGraph *self, void *)
+{
+    const CSRGraph &g = *self->graph;
+    return toNumpy(wrapBorrowed((PyObject *)self, g.inOffsets.data(), g.inOffsets.size(), sizeof(std::size_t), "Q"));
+}
+
+static PyObject *PyCSRGraph_in_edges(PyCSRGraph *self, void *)
+{
+    const CSRGraph &g = *self->graph;
+    return toNumpy(wrapBorrowed((PyObject *)self, g.inEdges.data(), g.inEdges.size(), sizeof(int), "i"));
+}
+
+static PyObject *PyCSRGraph_out_offsets(PyCSRGraph *self, void *)
+{
+    const CSRGraph &g = *self->graph;
+    return toNumpy(wrapBorrowed((PyObject *)self, g.outOffsets.data(), g.outOffsets.size(), sizeof(std::size_t), "Q"));
+}
+
+static PyObject *PyCSRGraph_out_edges(PyCSRGraph *self, void *)
+{
+    const CSRGraph &g = *self->graph;
+    return toNumpy(wrapBorrowed((PyObject *)self, g.outEdges.data(), g.outEdges.size(), sizeof(int), "i"));
+}
+
+static PyGetSetDef PyCSRGraph_getset[] = {
+    {"num_nodes", (getter)PyCSRGraph_num_nodes, nullptr, "Number of vertices", nullptr},
+    {"num_edges", (getter)PyCSRGraph_num_edges, nullptr, "Number of distinct edges", nullptr},
+    {"names", (getter)PyCSRGraph_names, nullptr, "Vertex labels, in vertex order", nullptr},
+    {"in_offsets", (getter)PyCSRGraph_in_offsets, nullptr, "CSR offsets of the parents (uint64, zero-copy)", nullptr},
+    {"in_edges", (getter)PyCSRGraph_in_edges, nullptr, "Parent vertex ids (int32, zero-copy)", nullptr},
+    {"out_offsets", (getter)PyCSRGraph_out_offsets, nullptr, "CSR offsets of the children (uint64, zero-copy)", nullptr},
+    {"out_edges", (getter)PyCSRGraph_out_edges, nullptr, "Child vertex ids (int32, zero-copy)", nullptr},
+    {nullptr},
+};
+
+static PyTypeObject PyCSRGraphType = {
+    PyVarObject_HEAD_INIT(nullptr, 0)
+    "gnncpu.Graph",
+};
+
+static const CSRGraph *graphArg(PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, &PyCSRGraphType))
+    {
+        PyErr_SetString(PyExc_TypeError, "expected a gnncpu.Graph");
+        return nullptr;
+    }
+    return ((PyCSRGraph *)obj)->graph;
+}
+
+// --- module functions -----------------------------------------------------------
+
+// C++ exceptions must not reach the interpreter. The engines run with the GIL
+// released, so the catch block records the error and raise() sets it once the
+// GIL is held again.
+class EngineError
+{
+public:
+    // Call from inside a catch (...) block
+    void capture()
+    {
+        try
+        {
+            throw;
+        }
+        catch (const std::bad_alloc &)
+        {
+            type = PyExc_MemoryError;
+            message = "out of memory";
+        }
+        catch (const std::logic_error &e)
+        {
+            type = PyExc_ValueError;
+            message = e.what();
+        }
+        catch (const std::exception &e)
+        {
+            type = PyExc_RuntimeError;
+            message = e.what();
+        }
+        catch (...)
+        {
+            type = PyExc_RuntimeError;
+            message = "unknown C++ exception";
+        }
+    }
+
+    // Set the Python error if one was captured; true if so
+    bool raise() const
+    {
+        if (type == nullptr)
+        {
+            return false;
+        }
+        PyErr_SetString(type, message.c_str());
+        return true;
+    }
+
+private:
+    PyObject *type = nullptr;
+    std::string message;
+};
+
+static PyObject *gnncpu_load_graph(PyObject *, PyObject *args)
+{
+    const char *fname;
+    if (!PyArg_ParseTuple(args, "s", &fname))
+    {
+        return nullptr;
+    }
+
+    if (!std::ifstream(fname).good())
+    {
+        errno = ENOENT;
+        return PyErr_SetFromErrnoWithFilename(PyExc_FileNotFoundError, fname);
+    }
+
+    CSRGraph *graph = nullptr;
+    EngineError error;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        graph = new CSRGraph(loadCSRGraph(fname));
+    }
+    catch (...)
+    {
+        error.capture();
+    }
+    Py_END_ALLOW_THREADS
+
+    if (error.raise())
+    {
+        return nullptr;
+    }
+    PyCSRGraph *self = PyObject_New(PyCSRGraph, &PyCSRGraphType);
+    if (self == nullptr)
+    {
+        delete graph;
+        return nullptr;
+    }
+    self->graph = graph;
+    return (PyObject *)self;
+}
+
+static PyObject *gnncpu_pagerank(PyObject *, PyObject *args, PyObject *kwargs)
+{
+    static const char *keywords[] = {"graph", "damping_factor", "iteration", "in_place", nullptr};
+    PyObject *graphObj;
+    double damping_factor = 0.15;
+    int iteration = 100;
+    int in_place = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|dip", (char **)keywords, &graphObj, &damping_factor, &iteration,
+                                     &in_place))
+    {
+        return nullptr;
+    }
+    const CSRGraph *graph = graphArg(graphObj);
+    if (graph == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::vector<double> pagerank;
+    EngineError error;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        pagerank = in_place ? runPageRankInPlace(*graph, damping_factor, iteration)
+                            : runPageRank(*graph, damping_factor, iteration);
+    }
+    catch (...)
+    {
+        error.capture();
+    }
+    Py_END_ALLOW_THREADS
+    if (error.raise())
+    {
+        return nullptr;
+    }
+    return toNumpy(wrapVector(std::move(pagerank)));
+}
+
+static PyObject *gnncpu_personalized_pagerank(PyObject *, PyObject *args, PyObject *kwargs)
+{
+    static const char *keywords[] = {"graph", "personalization", "damping_factor", "iteration", nullptr};
+    PyObject *graphObj;
+    PyObject *personalizationObj;
+    double damping_factor = 0.15;
+    int iteration = 100;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|di", (char **)keywords, &graphObj, &personalizationObj,
+                                     &damping_factor, &iteration))
+    {
+        return nullptr;
+    }
+    const CSRGraph *graph = graphArg(graphObj);
+    if (graph == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Any sequence of numbers, one per vertex
+    PyObject *seq = PySequence_Fast(personalizationObj, "personalization must be a sequence");
+    if (seq == nullptr)
+    {
+        return nullptr;
+    }
+    std::vector<double> personalization(PySequence_Fast_GET_SIZE(seq));
+    for (std::size_t i = 0; i < personalization.size(); ++i)
+    {
+        personalization[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, (Py_ssize_t)i));
+    }
+    Py_DECREF(seq);
+    if (PyErr_Occurred())
+    {
+        return nullptr;
+    }
+
+    std::vector<double> pagerank;
+    EngineError error;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        pagerank = runPersonalizedPageRank(*graph, damping_factor, personalization, iteration);
+    }
+    catch (...)
+    {
+        error.capture();
+    }
+    Py_END_ALLOW_THREADS
+    if (error.raise())
+    {
+        return nullptr;
+    }
+    return toNumpy(wrapVector(std::move(pagerank)));
+}
+
+static PyObject *gnncpu_hits(PyObject *, PyObject *args, PyObject *kwargs)
+{
+    static const char *keywords[] = {"graph", "iteration", nullptr};
+    PyObject *graphObj;
+    int iteration = 100;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", (char **)keywords, &graphObj, &iteration))
+    {
+        return nullptr;
+    }
+    const CSRGraph *graph = graphArg(graphObj);
+    if (graph == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::pair<std::vector<double>, std::vector<double>> authHub;
+    EngineError error;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        authHub = runHits(*graph, iteration);
+    }
+    catch (...)
+    {
+        error.capture();
+    }
+    Py_END_ALLOW_THREADS
+    if (error.raise())
+    {
+        return nullptr;
+    }
+
+    PyObject *auth = toNumpy(wrapVector(std::move(authHub.first)));
+    if (auth == nullptr)
+    {
+        return nullptr;
+    }
+    PyObject *hub = toNumpy(wrapVector(std::move(authHub.second)));
+    if (hub == nullptr)
+    {
+        Py_DECREF(auth);
+        return nullptr;
+    }
+    return Py_BuildValue("(NN)", auth, hub);
+}
+
+static PyObject *gnncpu_katz(PyObject *, PyObject *args, PyObject *kwargs)
+{
+    static const char *keywords[] = {"graph", "alpha", "beta", "iteration", nullptr};
+    PyObject *graphObj;
+    double alpha = 0.05;
+    double beta = 1.0;
+    int iteration = 100;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|ddi", (char **)keywords, &graphObj, &alpha, &beta, &iteration))
+    {
+        return nullptr;
+    }
+    const CSRGraph *graph = graphArg(graphObj);
+    if (graph == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::vector<double> katz;
+    EngineError error;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+        katz = runKatz(*graph, alpha, beta, iteration);
+    }
+    catch (...)
+    {
+        error.capture();
+    }
+    Py_END_ALLOW_THREADS
+    if (error.raise())
+    {
+        return nullptr;
+    }
+    return toNumpy(wrapVector(std::move(katz)));
+}
+
+static PyMethodDef gnncpu_methods[] = {
+    {"load_graph", (PyCFunction)gnncpu_load_graph, METH_VARARGS,
+     "load_graph(fname) -> Graph\n\nRead a 'parent,child' edge list into a compressed graph."},
+    {"pagerank", (PyCFunction)(void (*)(void))gnncpu_pagerank, METH_VARARGS | METH_KEYWORDS,
+     "pagerank(graph, damping_factor=0.15, iteration=100, in_place=False) -> ranks\n\n"
+     "in_place=True sweeps the vertices in order like main_PR.py and cpp_implementation.cpp do and gives\n"
+     "their ranks; the default synchronous update is parallel but converges to a different vector on\n"
+     "graphs with dangling vertices."},
+    {"personalized_pagerank", (PyCFunction)(void (*)(void))gnncpu_personalized_pagerank, METH_VARARGS | METH_KEYWORDS,
+     "personalized_pagerank(graph, personalization, damping_factor=0.15, iteration=100) -> ranks"},
+    {"hits", (PyCFunction)(void (*)(void))gnncpu_hits, METH_VARARGS | METH_KEYWORDS,
+     "hits(graph, iteration=100) -> (auth, hub)"},
+    {"katz", (PyCFunction)(void (*)(void))gnncpu_katz, METH_VARARGS | METH_KEYWORDS,
+     "katz(graph, alpha=0.05, beta=1.0, iteration=100) -> scores"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static struct PyModuleDef gnncpu_module = {
+    PyModuleDef_HEAD_INIT,
+    "gnncpu",
+    "Native graph loading and link analysis engines for main_PR.py",
+    -1,
+    gnncpu_methods,
+};
+
+PyMODINIT_FUNC PyInit_gnncpu(void)
+{
+    NativeArrayType.tp_basicsize = sizeof(NativeArray);
+    NativeArrayType.tp_dealloc = (destructor)NativeArray_dealloc;
+    NativeArrayType.tp_flags = Py_TPFLAGS_DEFAULT;
+    NativeArrayType.tp_doc = "1-d array in engine memory, exported through the buffer protocol (writable for results, read-only for Graph arrays)";
+    NativeArrayType.tp_as_buffer = &NativeArray_as_buffer;
+    NativeArrayType.tp_as_sequence = &NativeArray_as_sequence;
+    if (PyType_Ready(&NativeArrayType) < 0)
+    {
+        return nullptr;
+    }
+
+    PyCSRGraphType.tp_basicsize = sizeof(PyCSRGraph);
+    PyCSRGraphType.tp_dealloc = (destructor)PyCSRGraph_dealloc;
+    PyCSRGraphType.tp_flags = Py_TPFLAGS_DEFAULT;
+    PyCSRGraphType.tp_doc = "Compressed (CSR) graph, see csr_graph.h";
+    PyCSRGraphType.tp_getset = PyCSRGraph_getset;
+    if (PyType_Ready(&PyCSRGraphType) < 0)
+    {
+        return nullptr;
+    }
+
+    PyObject *module = PyModule_Create(&gnncpu_module);
+    if (module == nullptr)
+    {
+        return nullptr;
+    }
+    Py_INCREF(&NativeArrayType);
+    PyModule_AddObject(module, "NativeArray", (PyObject *)&NativeArrayType);
+    Py_INCREF(&PyCSRGraphType);
+    PyModule_AddObject(module, "Graph", (PyObject *)&PyCSRGraphType);
+    return module;
+}
@@ -0,0 +1,273 @@
+#ifndef RANK_OUTPUT_H
+#define RANK_OUTPUT_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Output of rank vectors (PageRank, auth, hub) for the drivers in this
+// directory. Writing every rank as setprecision(3) text, and echoing it to
+// stdout, costs more than the computation on large graphs, so the format and
+// what goes to stdout are options:
+//
+//   Text     : "<rank> " per vertex with the given precision, formatted in
+//              parallel chunks and written in order (the original format)
+//   Binary32 : RankFileHeader followed by the ranks as raw float
+//   Binary64 : RankFileHeader followed by the ranks as raw double
+//   None     : no result file
+//
+// topK > 0 additionally prints the k highest ranked vertices with their labels.
+
+enum class RankFormat
+{
+    Text,
+    Binary32,
+    Binary64,
+    None
+};
+
+class RankOutputOptions
+{
+public:
+    RankFormat format = RankFormat::Text;
+    int precision = 3;
+    int topK = 0;
+    // Echo every rank to stdout only for graphs up to this many vertices
+    std::size_t printLimit = 1000;
+};
+
+// Header of the binary result files, 24 bytes, native byte order
+struct RankFileHeader
+{
+    char magic[4];       // "RANK"
+    uint32_t version;    // 1
+    uint32_t valueBytes; // 4 (float) or 8 (double)
+    uint32_t reserved;
+    uint64_t count; // number of ranks that follow
+};
+
+inline bool parseRankFormat(const std::string &name, RankFormat &format)
+{
+    if (name == "text")
+        format = RankFormat::Text;
+    else if (name == "bin32")
+        format = RankFormat::Binary32;
+    else if (name == "bin64")
+        format = RankFormat::Binary64;
+    else if (name == "none")
+        format = RankFormat::None;
+    else
+        return false;
+    return true;
+}
+
+// Indices and values of the k largest ranks, highest first (ties by index).
+// Every thread selects the top k of its own slice, then the candidates are merged.
+inline std::vector<std::pair<std::size_t, double>> topKRanks(const std::vector<double> &ranks, std::size_t k)
+{
+    typedef std::pair<std::size_t, double> Entry;
+    auto higher = [](const Entry &a, const Entry &b)
+    { return a.second > b.second || (a.second == b.second && a.first < b.first); };
+
+    std::size_t n = ranks.size();
+    k = std::min(k, n);
+    std::vector<Entry> candidates;
+    if (k == 0)
+    {
+        return candidates;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        int threads = 1, tid = 0;
+#ifdef _OPENMP
+        threads = omp_get_num_threads();
+        tid = omp_get_thread_num();
+#endif
+        std::size_t begin = n * tid / threads;
+        std::size_t end = n * (tid + 1) / threads;
+        std::vector<Entry> local;
+        local.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            local.emplace_back(i, ranks[i]);
+        }
+        if (local.size() > k)
+        {
+            std::nth_element(local.begin(), local.begin() + k, local.end(), higher);
+            local.resize(k);
+        }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        candidates.insert(candidates.end(), local.begin(), local.end());
+    }
+
+    std::sort(candidates.begin(), candidates.end(), higher);
+    candidates.resize(k);
+    return candidates;
+}
+
+inline void printTopK(const std::vector<double> &ranks, const std::vector<std::string> &names, std::size_t k,
+                      const std::string &title)
+{
+    std::vector<std::pair<std::size_t, double>> top = topKRanks(ranks, k);
+    std::cout << "Top " << top.size() << " " << title << ":" << std::endl;
+    for (std::size_t i = 0; i < top.size(); ++i)
+    {
+        const std::string &label = top[i].first < names.size() ? names[top[i].first] : std::to_string(top[i].first);
+        std::cout << (i + 1) << "\t" << label << "\t" << top[i].second << std::endl;
+    }
+}
+
+inline bool writeRanksText(const std::vector<double> &ranks, const std::string &path, int precision)
+{
+    std::ofstream outfile(path, std::ios::binary);
+    if (!outfile.is_open())
+    {
+        return false;
+    }
+
+    const std::size_t chunk = 1 << 16;
+    const std::size_t chunksPerRound = 64;
+    std::size_t n = ranks.size();
+    std::size_t numChunks = (n + chunk - 1) / chunk;
+    std::vector<std::string> text(chunksPerRound);
+    std::vector<char> failed(chunksPerRound);
+
+    // Format a bounded number of chunks in parallel, then write them in order
+    for (std::size_t first = 0; first < numChunks; first += chunksPerRound)
+    {
+        long long count = (long long)std::min(chunksPerRound, numChunks - first);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (long long c = 0; c < count; ++c)
+        {
+            std::size_t begin = (first + c) * chunk;
+            std::size_t end = std::min(n, begin + chunk);
+            std::string &out = text[c];
+            out.clear();
+            failed[c] = 0;
+            char buf[64];
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                int len = std::snprintf(buf, sizeof(buf), "%.*f ", precision, ranks[i]);
+                if (len < 0)
+                {
+                    failed[c] = 1;
+                    break;
+                }
+                if ((std::size_t)len < sizeof(buf))
+                {
+                    out.append(buf, len);
+                    continue;
+                }
+                // High precision: format again into a buffer of the reported size
+                std::vector<char> big(len + 1);
+                std::snprintf(big.data(), big.size(), "%.*f ", precision, ranks[i]);
+                out.append(big.data(), len);
+            }
+        }
+        for (long long c = 0; c < count; ++c)
+        {
+            if (failed[c])
+            {
+                return false;
+            }
+            outfile.write(text[c].data(), text[c].size());
+        }
+    }
+    outfile << "\n";
+    return (bool)outfile;
+}
+
+inline bool writeRanksBinary(const std::vector<double> &ranks, const std::string &path, bool asFloat)
+{
+    std::ofstream outfile(path, std::ios::binary);
+    if (!outfile.is_open())
+    {
+        return false;
+    }
+
+    RankFileHeader header;
+    std::memcpy(header.magic, "RANK", 4);
+    header.version = 1;
+    header.valueBytes = asFloat ? 4 : 8;
+    header.reserved = 0;
+    header.count = ranks.size();
+    outfile.write((const char *)&header, sizeof(header));
+
+    if (!asFloat)
+    {
+        outfile.write((const char *)ranks.data(), ranks.size() * sizeof(double));
+        return (bool)outfile;
+    }
+
+    const std::size_t chunk = 1 << 20;
+    std::vector<float> buf(std::min(chunk, ranks.size()));
+    for (std::size_t begin = 0; begin < ranks.size(); begin += chunk)
+    {
+        std::size_t count = std::min(chunk, ranks.size() - begin);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buf[i] = (float)ranks[begin + i];
+        }
+        outfile.write((const char *)buf.data(), count * sizeof(float));
+    }
+    return (bool)outfile;
+}
+
+// Print and store one rank vector. path is the result path without extension;
+// ".txt" or ".bin" is appended according to the format.
+inline void writeRanks(const std::vector<double> &ranks, const std::vector<std::string> &names,
+                       const std::string &title, const std::string &path, const RankOutputOptions &options)
+{
+    if (ranks.size() <= options.printLimit)
+    {
+        std::cout << title << ":" << std::endl;
+        for (double r : ranks)
+        {
+            std::cout << r << " ";
+        }
+        std::cout << std::endl;
+    }
+    if (options.topK > 0)
+    {
+        printTopK(ranks, names, options.topK, title);
+    }
+
+    bool ok = true;
+    switch (options.format)
+    {
+    case RankFormat::Text:
+        ok = writeRanksText(ranks, path + ".txt", options.precision);
+        break;
+    case RankFormat::Binary32:
+        ok = writeRanksBinary(ranks, path + ".bin", true);
+        break;
+    case RankFormat::Binary64:
+        ok = writeRanksBinary(ranks, path + ".bin", false);
+        break;
+    case RankFormat::None:
+        break;
+    }
+    if (!ok)
+    {
+        std::cerr << "could not write " << path << std::endl;
+    }
+}
+
+#endif
@@ -0,0 +1,392 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <errno.h>
+
+// Message exchange between the worker processes of distributed_pagerank.cpp.
+// A transport is created in the parent before fork() and attach(rank) is called
+// in each child. exchange() is a blocking all-to-all: send[q] is delivered to
+// process q and whatever q sent to us ends up in recv[q]. Messages are framed
+// with a 64-bit length so the receiver does not need to know sizes up front.
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    virtual void attach(int rank) = 0;
+
+    int rank() const { return myRank; }
+    int size() const { return numProcs; }
+
+    void exchange(const std::vector<std::vector<char>> &send, std::vector<std::vector<char>> &recv)
+    {
+        struct Channel
+        {
+            uint64_t length = 0;
+            std::size_t done = 0; // bytes moved, header included
+        };
+        const std::size_t header = sizeof(uint64_t);
+        std::vector<Channel> out(numProcs), in(numProcs);
+        int pending = 0;
+
+        recv.assign(numProcs, std::vector<char>());
+        for (int q = 0; q < numProcs; ++q)
+        {
+            if (q == myRank)
+            {
+                recv[q] = send[q];
+                continue;
+            }
+            out[q].length = send[q].size();
+            pending += 2;
+        }
+
+        while (pending > 0)
+        {
+            bool progress = false;
+            for (int q = 0; q < numProcs; ++q)
+            {
+                if (q == myRank)
+                {
+                    continue;
+                }
+
+                Channel &o = out[q];
+                std::size_t total = header + o.length;
+                while (o.done < total)
+                {
+                    std::size_t n;
+                    if (o.done < header)
+                    {
+                        n = trySend(q, (const char *)&o.length + o.done, header - o.done);
+                    }
+                    else
+                    {
+                        n = trySend(q, send[q].data() + (o.done - header), total - o.done);
+                    }
+                    if (n == 0)
+                    {
+                        break;
+                    }
+                    o.done += n;
+                    progress = true;
+                    if (o.done == total)
+                    {
+                        pending--;
+                    }
+                }
+
+                Channel &i = in[q];
+                while (i.done < header || i.done < header + i.length)
+                {
+                    std::size_t n;
+                    if (i.done < header)
+                    {
+                        n = tryRecv(q, (char *)&i.length + i.done, header - i.done);
+                        if (n > 0 && i.done + n == header)
+                        {
+                            recv[q].resize(i.length);
+                        }
+                    }
+                    else
+                    {
+                        n = tryRecv(q, recv[q].data() + (i.done - header), header + i.length - i.done);
+                    }
+                    if (n == 0)
+                    {
+                        break;
+                    }
+                    i.done += n;
+                    progress = true;
+                    if (i.done >= header && i.done == header + i.length)
+                    {
+                        pending--;
+                    }
+                }
+            }
+            if (pending > 0 && !progress)
+            {
+                std::vector<bool> sending(numProcs), receiving(numProcs);
+                for (int q = 0; q < numProcs; ++q)
+                {
+                    sending[q] = q != myRank && out[q].done < header + out[q].length;
+                    receiving[q] = q != myRank && (in[q].done < header || in[q].done < header + in[q].length);
+                }
+                waitForProgress(sending, receiving);
+            }
+        }
+    }
+
+    // Sum of value over all processes
+    double allreduceSum(double value)
+    {
+        std::vector<std::vector<char>> send(numProcs, std::vector<char>(sizeof(double)));
+        std::vector<std::vector<char>> recv;
+        for (auto &buf : send)
+        {
+            std::memcpy(buf.data(), &value, sizeof(double));
+        }
+        exchange(send, recv);
+        double sum = 0.0;
+        for (auto &buf : recv)
+        {
+            double v;
+            std::memcpy(&v, buf.data(), sizeof(double));
+            sum += v;
+        }
+        return sum;
+    }
+
+protected:
+    int myRank = 0;
+    int numProcs = 1;
+
+    // Move up to len bytes to/from peer without blocking, return the count moved
+    virtual std::size_t trySend(int peer, const char *data, std::size_t len) = 0;
+    virtual std::size_t tryRecv(int peer, char *data, std::size_t len) = 0;
+
+    // Block until one of the unfinished channels (sending[q] / receiving[q])
+    // can make progress
+    virtual void waitForProgress(const std::vector<bool> &sending, const std::vector<bool> &receiving) = 0;
+};
+
+// One socketpair() per pair of processes, switched to non-blocking mode so that
+// exchange() can interleave sends and receives without deadlocking on full
+// socket buffers.
+class SocketTransport : public Transport
+{
+public:
+    explicit SocketTransport(int nprocs)
+    {
+        numProcs = nprocs;
+        fds.assign(nprocs, std::vector<int>(nprocs, -1));
+        for (int p = 0; p < nprocs; ++p)
+        {
+            for (int q = p + 1; q < nprocs; ++q)
+            {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+                {
+                    throw std::runtime_error("socketpair failed: " + std::string(strerror(errno)));
+                }
+                fds[p][q] = sv[0];
+                fds[q][p] = sv[1];
+            }
+        }
+    }
+
+    ~SocketTransport()
+    {
+        for (auto &row : fds)
+        {
+            for (int fd : row)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+        }
+    }
+
+    void attach(int rank) override
+    {
+        myRank = rank;
+        // Keep only our own end of each pair
+        for (int p = 0; p < numProcs; ++p)
+        {
+            for (int q = 0; q < numProcs; ++q)
+            {
+                if (p != rank && fds[p][q] >= 0)
+                {
+                    close(fds[p][q]);
+                    fds[p][q] = -1;
+                }
+            }
+        }
+        for (int q = 0; q < numProcs; ++q)
+        {
+            if (fds[rank][q] >= 0)
+            {
+                fcntl(fds[rank][q], F_SETFL, fcntl(fds[rank][q], F_GETFL) | O_NONBLOCK);
+            }
+        }
+    }
+
+protected:
+    std::size_t trySend(int peer, const char *data, std::size_t len) override
+    {
+        ssize_t n = ::send(fds[myRank][peer], data, len, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                return 0;
+            }
+            throw std::runtime_error("send failed: " + std::string(strerror(errno)));
+        }
+        return (std::size_t)n;
+    }
+
+    std::size_t tryRecv(int peer, char *data, std::size_t len) override
+    {
+        ssize_t n = ::recv(fds[myRank][peer], data, len, 0);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                return 0;
+            }
+            throw std::runtime_error("recv failed: " + std::string(strerror(errno)));
+        }
+        if (n == 0 && len > 0)
+        {
+            throw std::runtime_error("peer " + std::to_string(peer) + " closed the connection");
+        }
+        return (std::size_t)n;
+    }
+
+    void waitForProgress(const std::vector<bool> &sending, const std::vector<bool> &receiving) override
+    {
+        // Only wait on what is still pending: an idle socket is always
+        // writable, so asking for POLLOUT on a finished send would spin
+        std::vector<pollfd> pfds;
+        for (int q = 0; q < numProcs; ++q)
+        {
+            short events = (sending[q] ? POLLOUT : 0) | (receiving[q] ? POLLIN : 0);
+            if (events != 0)
+            {
+                pfds.push_back({fds[myRank][q], events, 0});
+            }
+        }
+        if (!pfds.empty())
+        {
+            poll(pfds.data(), pfds.size(), -1);
+        }
+    }
+
+private:
+    std::vector<std::vector<int>> fds;
+};
+
+// A single-producer/single-consumer byte ring per ordered pair of processes,
+// living in an anonymous MAP_SHARED mapping that the children inherit.
+class SharedMemoryTransport : public Transport
+{
+public:
+    SharedMemoryTransport(int nprocs, std::size_t ringBytes = 1 << 20)
+        : capacity(ringBytes)
+    {
+        numProcs = nprocs;
+        stride = sizeof(Ring) + capacity;
+        stride = (stride + 63) & ~(std::size_t)63;
+        mappedBytes = stride * nprocs * nprocs;
+        base = (char *)mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
+        }
+        for (int i = 0; i < nprocs * nprocs; ++i)
+        {
+            new (base + i * stride) Ring();
+        }
+    }
+
+    ~SharedMemoryTransport()
+    {
+        munmap(base, mappedBytes);
+    }
+
+    void attach(int rank) override
+    {
+        myRank = rank;
+    }
+
+protected:
+    std::size_t trySend(int peer, const char *data, std::size_t len) override
+    {
+        Ring *r = ring(myRank, peer);
+        uint64_t head = r->head.load(std::memory_order_relaxed);
+        uint64_t tail = r->tail.load(std::memory_order_acquire);
+        std::size_t n = std::min<std::size_t>(len, capacity - (head - tail));
+        copyIn(r, head, data, n);
+        r->head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    std::size_t tryRecv(int peer, char *data, std::size_t len) override
+    {
+        Ring *r = ring(peer, myRank);
+        uint64_t tail = r->tail.load(std::memory_order_relaxed);
+        uint64_t head = r->head.load(std::memory_order_acquire);
+        std::size_t n = std::min<std::size_t>(len, head - tail);
+        copyOut(r, tail, data, n);
+        r->tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    void waitForProgress(const std::vector<bool> &, const std::vector<bool> &) override
+    {
+        sched_yield();
+    }
+
+private:
+    struct Ring
+    {
+        alignas(64) std::atomic<uint64_t> head{0}; // written by the sender
+        alignas(64) std::atomic<uint64_t> tail{0}; // written by the receiver
+    };
+
+    std::size_t capacity;
+    std::size_t stride;
+    std::size_t mappedBytes;
+    char *base;
+
+    Ring *ring(int from, int to) { return (Ring *)(base + (from * numProcs + to) * stride); }
+    char *bytes(Ring *r) { return (char *)r + sizeof(Ring); }
+
+    void copyIn(Ring *r, uint64_t pos, const char *data, std::size_t n)
+    {
+        std::size_t at = pos % capacity;
+        std::size_t first = std::min(n, capacity - at);
+        std::memcpy(bytes(r) + at, data, first);
+        std::memcpy(bytes(r), data + first, n - first);
+    }
+
+    void copyOut(Ring *r, uint64_t pos, char *data, std::size_t n)
+    {
+        std::size_t at = pos % capacity;
+        std::size_t first = std::min(n, capacity - at);
+        std::memcpy(data, bytes(r) + at, first);
+        std::memcpy(data + first, bytes(r), n - first);
+    }
+};
+
+inline Transport *createTransport(const std::string &kind, int nprocs)
+{
+    if (kind == "socket")
+    {
+        return new SocketTransport(nprocs);
+    }
+    if (kind == "shm")
+    {
+        return new SharedMemoryTransport(nprocs);
+    }
+    throw std::invalid_argument("unknown transport '" + kind + "' (expected socket or shm)");
+}
+
+#endif
@@ -3,6 +3,11 @@ import numpy as np
 import os
 import copy
 
+try:
+    import gnncpu  # native engine, built with `python setup.py build_ext --inplace`
+except ImportError:
+    gnncpu = None
+
 class Graph:
     def __init__(self):
         self.nodes = []
@@ -124,11 +129,11 @@ def PageRank(graph, d, iteration=100):
     for i in range(iteration):
         PageRank_one_iter(graph, d)
 
-def output_PageRank(iteration, graph, damping_factor, result_dir, fname):
+def save_PageRank(pagerank, result_dir, fname):
+    # Shared by both engines so they print and store ranks in the same format
     pagerank_fname = '_PageRank.txt'
 
-    PageRank(graph, damping_factor, iteration)
-    pagerank_list = graph.get_pagerank_list()
+    pagerank_list = np.round(np.asarray(pagerank, dtype='float32'), 3)
     print('PageRank:')
     print(pagerank_list)
     print()
@@ -136,6 +141,16 @@ def output_PageRank(iteration, graph, damping_factor, result_dir, fname):
     os.makedirs(path, exist_ok=True)
     np.savetxt(os.path.join(path, fname + pagerank_fname), pagerank_list, fmt='%.3f', newline=" ")
 
+def output_PageRank(iteration, graph, damping_factor, result_dir, fname):
+    PageRank(graph, damping_factor, iteration)
+    save_PageRank(graph.get_pagerank_list(), result_dir, fname)
+
+def output_PageRank_native(iteration, file_path, damping_factor, result_dir, fname):
+    # Computed by the native engine with the same in-place update order as
+    # PageRank_one_iter, so the ranks match output_PageRank
+    graph = gnncpu.load_graph(file_path)
+    save_PageRank(gnncpu.pagerank(graph, damping_factor, iteration, in_place=True), result_dir, fname)
+
 
 if __name__ == '__main__':
 
@@ -159,6 +174,11 @@ if __name__ == '__main__':
                          help='Iteration (int)',
                          default=500,
                          type='int')
+    optparser.add_option('--engine',
+                         dest='engine',
+                         help='python or native (needs the gnncpu module)',
+                         default='python',
+                         choices=['python', 'native'])
 
     (options, args) = optparser.parse_args()
 
@@ -170,6 +190,11 @@ if __name__ == '__main__':
     result_dir = 'result'
     fname = file_path.split('/')[-1].split('.')[0]
 
-    graph = init_graph(file_path)
-    #sim = Similarity(graph, decay_factor)
-    output_PageRank(iteration, graph, damping_factor, result_dir, fname)
+    if options.engine == 'native':
+        if gnncpu is None:
+            optparser.error('--engine native needs the gnncpu module, build it with `python setup.py build_ext --inplace`')
+        output_PageRank_native(iteration, file_path, damping_factor, result_dir, fname)
+    else:
+        graph = init_graph(file_path)
+        #sim = Similarity(graph, decay_factor)
+        output_PageRank(iteration, graph, damping_factor, result_dir, fname)
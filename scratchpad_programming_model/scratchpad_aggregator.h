@@ -0,0 +1,277 @@
+/*
+ * Software emulation of the VAQUERO scratchpad (ASPM) execution modes
+ * described in vaquero_hist_examples.cc and vaquero_aggregation_example.cc,
+ * so the access patterns can be measured on an ordinary CPU.
+ *
+ * 1. direct_scratchpad : direct mode. A small table indexed by the key
+ *                        itself (e.g. an 8-bit histogram). Stands in for
+ *                        svVaqAdd_dir_aspm_u32 / aspm_load_dir_u32.
+ * 2. assoc_scratchpad  : associative mode. An open-addressed key/value
+ *                        table sized to stay in L1/L2. When a key does not
+ *                        fit in its set, the oldest entry of the set is moved
+ *                        to the replacement buffer; a full buffer is drained
+ *                        into the backing array by scatter-add. Stands in for
+ *                        svVaqAdd_asso_aspm_u32 / aspm_buffer_size /
+ *                        aspm_read_buffer / aspm_read_table.
+ *
+ * Both modes accumulate into the scratchpad and only touch the backing
+ * array on eviction and on flush(). When keys repeat (skewed histograms,
+ * high degree vertices) that is far fewer backing writes than a naive
+ * scatter-add does, which is the benefit the hardware scratchpad gives. In
+ * this software emulation the table lookup costs more than the cache miss it
+ * saves, so it runs slower than the naive loop; what it measures is the
+ * backing traffic, reported through scratchpad_stats.
+ */
+
+#ifndef SCRATCHPAD_AGGREGATOR_H
+#define SCRATCHPAD_AGGREGATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <vector>
+
+// Backing array traffic of one associative-mode run. A naive scatter-add
+// writes the backing array once per update.
+struct scratchpad_stats {
+   uint64_t updates;        // add() calls
+   uint64_t evictions;      // entries pushed out of the table
+   uint64_t backing_writes; // evictions plus entries written back by flush()
+};
+
+template <typename V>
+class direct_scratchpad {
+public:
+   explicit direct_scratchpad(uint32_t size) : table(size, V()) {}
+
+   // Equivalent of clear_aspm
+   void clear() {
+      for (V &v : table)
+         v = V();
+   }
+
+   // Equivalent of svVaqAdd_dir_aspm: table[key] += value
+   void add(uint32_t key, V value) {
+      assert(key < table.size());
+      table[key] += value;
+   }
+
+   // Equivalent of aspm_load_dir
+   V load(uint32_t key) const { return table[key]; }
+
+   uint32_t size() const { return (uint32_t)table.size(); }
+
+   // Add the table to backing[base .. base + size) and clear it
+   void flush(V *backing, uint64_t base = 0) {
+      for (size_t i = 0; i < table.size(); i++) {
+         backing[base + i] += table[i];
+         table[i] = V();
+      }
+   }
+
+private:
+   std::vector<V> table;
+};
+
+template <typename V>
+class assoc_scratchpad {
+public:
+   static const uint32_t empty_key = 0xffffffffu;
+   static const uint32_t ways = 8;
+
+   // table_entries is rounded up to a power of two sets of ways; the default
+   // (4096 entries of 4-byte keys plus values) fits a 32-48KB L1
+   assoc_scratchpad(V *backing, uint32_t table_entries = 4096,
+         uint32_t buffer_entries = 64)
+      : backing(backing),
+        num_sets(round_up_pow2((table_entries + ways - 1) / ways)),
+        keys((size_t)num_sets * ways, empty_key),
+        values((size_t)num_sets * ways, V()),
+        victim(num_sets, 0),
+        buffer_keys(buffer_entries),
+        buffer_values(buffer_entries),
+        buffer_size(0),
+        updates(0),
+        evictions(0),
+        backing_writes(0) {}
+
+   ~assoc_scratchpad() { flush(); }
+
+   // Pending values would be added to the backing array once per copy
+   assoc_scratchpad(const assoc_scratchpad &) = delete;
+   assoc_scratchpad &operator=(const assoc_scratchpad &) = delete;
+
+   // Equivalent of svVaqAdd_asso_aspm: accumulate value under key.
+   // key must not be empty_key.
+   void add(uint32_t key, V value) {
+      assert(key != empty_key);
+      updates++;
+      uint32_t set = hash(key) & (num_sets - 1);
+      uint32_t *k = &keys[(size_t)set * ways];
+      V *v = &values[(size_t)set * ways];
+      for (uint32_t w = 0; w < ways; w++) {
+         if (k[w] == key) {
+            v[w] += value;
+            return;
+         }
+         if (k[w] == empty_key) {
+            k[w] = key;
+            v[w] = value;
+            return;
+         }
+      }
+      // Set is full: evict round-robin into the replacement buffer
+      uint32_t w = victim[set];
+      victim[set] = (uint8_t)((w + 1) % ways);
+      evict(k[w], v[w]);
+      k[w] = key;
+      v[w] = value;
+   }
+
+   // Equivalent of aspm_buffer_size
+   uint32_t pending_evictions() const { return buffer_size; }
+
+   // Total number of entries pushed out of the table so far
+   uint64_t eviction_count() const { return evictions; }
+
+   // Counters since construction
+   scratchpad_stats stats() const {
+      scratchpad_stats s = {updates, evictions, backing_writes};
+      return s;
+   }
+
+   // Scatter-add the replacement buffer into the backing array
+   void drain_buffer() {
+      for (uint32_t i = 0; i < buffer_size; i++)
+         backing[buffer_keys[i]] += buffer_values[i];
+      backing_writes += buffer_size;
+      buffer_size = 0;
+   }
+
+   // Write everything back (aspm_read_table + update) and clear the table
+   void flush() {
+      drain_buffer();
+      for (size_t i = 0; i < keys.size(); i++) {
+         if (keys[i] != empty_key) {
+            backing[keys[i]] += values[i];
+            backing_writes++;
+            keys[i] = empty_key;
+            values[i] = V();
+         }
+      }
+   }
+
+private:
+   V *backing;
+   uint32_t num_sets;
+   std::vector<uint32_t> keys;
+   std::vector<V> values;
+   std::vector<uint8_t> victim;
+   std::vector<uint32_t> buffer_keys;
+   std::vector<V> buffer_values;
+   uint32_t buffer_size;
+   uint64_t updates;
+   uint64_t evictions;
+   uint64_t backing_writes;
+
+   static uint32_t round_up_pow2(uint32_t x) {
+      uint32_t p = 1;
+      while (p < x)
+         p <<= 1;
+      return p;
+   }
+
+   static uint32_t hash(uint32_t key) {
+      return (uint32_t)(((uint64_t)key * 0x9e3779b97f4a7c15ull) >> 32);
+   }
+
+   void evict(uint32_t key, V value) {
+      if (buffer_size == buffer_keys.size())
+         drain_buffer();
+      buffer_keys[buffer_size] = key;
+      buffer_values[buffer_size] = value;
+      buffer_size++;
+      evictions++;
+   }
+};
+
+/*
+ * Applications. Each has a naive scatter-add counterpart for comparison. The
+ * associative ones optionally report their backing traffic in *stats.
+ */
+
+// 8-bit histogram of the low byte, direct mode (vaquero_hist_examples.cc)
+inline void histogram_direct(const uint32_t *input_values, size_t input_size,
+      uint32_t *histogram) {
+   direct_scratchpad<uint32_t> aspm(256);
+   for (size_t it = 0; it < input_size; it++)
+      aspm.add(input_values[it] & 0x000000ff, 1);
+   aspm.flush(histogram);
+}
+
+// 2^bits bin histogram that does not fit the scratchpad, associative mode.
+// bits must be below 32 so no input can collide with empty_key.
+inline void histogram_assoc(const uint32_t *input_values, size_t input_size,
+      uint32_t bits, uint32_t *histogram, scratchpad_stats *stats = nullptr) {
+   assert(bits < 32);
+   uint32_t mask = (1u << bits) - 1;
+   assoc_scratchpad<uint32_t> aspm(histogram);
+   for (size_t it = 0; it < input_size; it++)
+      aspm.add(input_values[it] & mask, 1);
+   aspm.flush();
+   if (stats)
+      *stats = aspm.stats();
+}
+
+inline void histogram_naive(const uint32_t *input_values, size_t input_size,
+      uint32_t bits, uint32_t *histogram) {
+   uint32_t mask = bits >= 32 ? 0xffffffffu : ((1u << bits) - 1);
+   for (size_t it = 0; it < input_size; it++)
+      histogram[input_values[it] & mask]++;
+}
+
+// Degree counting while building a graph: degree[endpoint[e]]++ for every edge
+inline void degree_count_assoc(const uint32_t *endpoint, size_t num_edges,
+      uint32_t *degree, scratchpad_stats *stats = nullptr) {
+   assoc_scratchpad<uint32_t> aspm(degree);
+   for (size_t e = 0; e < num_edges; e++)
+      aspm.add(endpoint[e], 1);
+   aspm.flush();
+   if (stats)
+      *stats = aspm.stats();
+}
+
+inline void degree_count_naive(const uint32_t *endpoint, size_t num_edges,
+      uint32_t *degree) {
+   for (size_t e = 0; e < num_edges; e++)
+      degree[endpoint[e]]++;
+}
+
+// Push-based rank accumulation over a CSR out-adjacency:
+// next_rank[child] += contribution[node] for every edge node -> child
+inline void push_rank_assoc(const uint64_t *out_offsets,
+      const uint32_t *out_edges, uint32_t num_nodes,
+      const double *contribution, double *next_rank,
+      scratchpad_stats *stats = nullptr) {
+   assoc_scratchpad<double> aspm(next_rank);
+   for (uint32_t node = 0; node < num_nodes; node++) {
+      double c = contribution[node];
+      for (uint64_t e = out_offsets[node]; e < out_offsets[node + 1]; e++)
+         aspm.add(out_edges[e], c);
+   }
+   aspm.flush();
+   if (stats)
+      *stats = aspm.stats();
+}
+
+inline void push_rank_naive(const uint64_t *out_offsets,
+      const uint32_t *out_edges, uint32_t num_nodes,
+      const double *contribution, double *next_rank) {
+   for (uint32_t node = 0; node < num_nodes; node++) {
+      double c = contribution[node];
+      for (uint64_t e = out_offsets[node]; e < out_offsets[node + 1]; e++)
+         next_rank[out_edges[e]] += c;
+   }
+}
+
+#endif
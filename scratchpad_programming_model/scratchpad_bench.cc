@@ -0,0 +1,176 @@
+/*
+ * Benchmarks the software scratchpad (scratchpad_aggregator.h) against a
+ * naive scatter-add for the three patterns we care about: histogramming,
+ * degree counting during graph build and push-based rank accumulation.
+ * Every kernel is checked against its naive counterpart. The emulation is
+ * slower than the naive loop in software; for the associative kernels the
+ * second line of each row is the number that matters, the backing array
+ * writes (evictions plus entries flushed at the end) against the one write
+ * per update the naive loop does.
+ *
+ * Keys are drawn either uniformly or from a power law (density ~ 1/x,
+ * scattered over the key range) to mimic the degree distribution of real
+ * graphs, where most updates hit a few hot vertices.
+ *
+ * g++ -O3 -march=native -o scratchpad_bench scratchpad_bench.cc
+ * ./scratchpad_bench [log2_num_keys] [num_updates_millions]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "scratchpad_aggregator.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+template <typename F>
+double best_ms(F &&run, int repeat = 3) {
+   double best = 1e30;
+   for (int r = 0; r < repeat; r++) {
+      bench_clock::time_point start = bench_clock::now();
+      run();
+      double ms = std::chrono::duration<double, std::milli>(
+            bench_clock::now() - start).count();
+      if (ms < best)
+         best = ms;
+   }
+   return best;
+}
+
+std::vector<uint32_t> make_keys(size_t count, uint32_t num_keys, bool skewed,
+      uint32_t seed) {
+   std::mt19937 rng(seed);
+   std::uniform_real_distribution<double> u(0.0, 1.0);
+   std::vector<uint32_t> keys(count);
+   for (size_t i = 0; i < count; i++) {
+      uint64_t x;
+      if (skewed)
+         x = (uint64_t)std::pow((double)num_keys, u(rng)) - 1;
+      else
+         x = (uint64_t)(u(rng) * num_keys);
+      if (x >= num_keys)
+         x = num_keys - 1;
+      // scatter the hot keys over the whole range
+      keys[i] = (uint32_t)((x * 2654435761ull) % num_keys);
+   }
+   return keys;
+}
+
+void report(const char *name, double naive_ms, double aspm_ms, bool ok) {
+   std::printf("%-28s naive %9.2f ms   scratchpad %9.2f ms   speedup %5.2fx  %s\n",
+         name, naive_ms, aspm_ms, naive_ms / aspm_ms, ok ? "ok" : "MISMATCH");
+}
+
+void report_traffic(const scratchpad_stats &stats) {
+   double updates = stats.updates > 0 ? (double)stats.updates : 1.0;
+   std::printf("%-28s updates %llu   evictions %llu (%.1f%%)   backing writes %llu (%.1f%%)\n",
+         "", (unsigned long long)stats.updates,
+         (unsigned long long)stats.evictions, 100.0 * stats.evictions / updates,
+         (unsigned long long)stats.backing_writes,
+         100.0 * stats.backing_writes / updates);
+}
+
+int main(int argc, char **argv) {
+   uint32_t log2_keys = argc > 1 ? (uint32_t)std::atoi(argv[1]) : 22;
+   size_t updates = (size_t)(argc > 2 ? std::atof(argv[2]) : 32.0) * 1000000;
+   uint32_t num_keys = 1u << log2_keys;
+   int failures = 0;
+
+   // 8-bit histogram, direct mode
+   {
+      std::vector<uint32_t> input = make_keys(updates, 0xffffffffu, false, 1);
+      std::vector<uint32_t> a(256), b(256);
+      double naive = best_ms([&] {
+         std::fill(a.begin(), a.end(), 0);
+         histogram_naive(input.data(), input.size(), 8, a.data());
+      });
+      double aspm = best_ms([&] {
+         std::fill(b.begin(), b.end(), 0);
+         histogram_direct(input.data(), input.size(), b.data());
+      });
+      report("histogram 8-bit direct", naive, aspm, a == b);
+      failures += a != b;
+   }
+
+   for (int skewed = 0; skewed < 2; skewed++) {
+      const char *dist = skewed ? "power-law" : "uniform";
+      char name[64];
+
+      // 16-bit histogram, associative mode
+      {
+         std::vector<uint32_t> input = make_keys(updates, 1u << 16, skewed, 2);
+         std::vector<uint32_t> a(1u << 16), b(1u << 16);
+         scratchpad_stats stats;
+         double naive = best_ms([&] {
+            std::fill(a.begin(), a.end(), 0);
+            histogram_naive(input.data(), input.size(), 16, a.data());
+         });
+         double aspm = best_ms([&] {
+            std::fill(b.begin(), b.end(), 0);
+            histogram_assoc(input.data(), input.size(), 16, b.data(), &stats);
+         });
+         std::snprintf(name, sizeof(name), "histogram 16-bit %s", dist);
+         report(name, naive, aspm, a == b);
+         report_traffic(stats);
+         failures += a != b;
+      }
+
+      // Degree counting over num_keys vertices
+      {
+         std::vector<uint32_t> endpoint = make_keys(updates, num_keys, skewed, 3);
+         std::vector<uint32_t> a(num_keys), b(num_keys);
+         scratchpad_stats stats;
+         double naive = best_ms([&] {
+            std::fill(a.begin(), a.end(), 0);
+            degree_count_naive(endpoint.data(), endpoint.size(), a.data());
+         });
+         double aspm = best_ms([&] {
+            std::fill(b.begin(), b.end(), 0);
+            degree_count_assoc(endpoint.data(), endpoint.size(), b.data(),
+                  &stats);
+         });
+         std::snprintf(name, sizeof(name), "degree count %s", dist);
+         report(name, naive, aspm, a == b);
+         report_traffic(stats);
+         failures += a != b;
+      }
+
+      // Push-based rank accumulation, updates / num_keys edges per vertex
+      {
+         std::vector<uint32_t> out_edges = make_keys(updates, num_keys, skewed, 4);
+         std::vector<uint64_t> out_offsets(num_keys + 1);
+         for (uint32_t v = 0; v <= num_keys; v++)
+            out_offsets[v] = (uint64_t)updates * v / num_keys;
+         std::vector<double> contribution(num_keys);
+         for (uint32_t v = 0; v < num_keys; v++)
+            contribution[v] = 1.0 / (1.0 + v % 97);
+         std::vector<double> a(num_keys), b(num_keys);
+         scratchpad_stats stats;
+         double naive = best_ms([&] {
+            std::fill(a.begin(), a.end(), 0.0);
+            push_rank_naive(out_offsets.data(), out_edges.data(), num_keys,
+                  contribution.data(), a.data());
+         });
+         double aspm = best_ms([&] {
+            std::fill(b.begin(), b.end(), 0.0);
+            push_rank_assoc(out_offsets.data(), out_edges.data(), num_keys,
+                  contribution.data(), b.data(), &stats);
+         });
+         // Summation order differs, compare with a relative tolerance
+         bool ok = true;
+         for (uint32_t v = 0; v < num_keys; v++)
+            ok = ok && std::fabs(a[v] - b[v]) <= 1e-9 * std::fabs(a[v]) + 1e-12;
+         std::snprintf(name, sizeof(name), "push rank %s", dist);
+         report(name, naive, aspm, ok);
+         report_traffic(stats);
+         failures += !ok;
+      }
+   }
+
+   return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+# Builds the native engine used by main_PR.py --engine native:
+#
+#     python setup.py build_ext --inplace
+#
+# OpenMP is used when the compiler accepts -fopenmp; otherwise (e.g. Apple clang
+# without libomp, or MSVC) the engine is built serial, which link_analysis.h
+# supports.
+import os
+import tempfile
+
+from setuptools import setup, Extension
+from setuptools.command.build_ext import build_ext
+from setuptools.errors import CompileError, LinkError
+
+OPENMP_CHECK = '#include <omp.h>\nint main() { return omp_get_max_threads() > 0 ? 0 : 1; }\n'
+
+
+def has_openmp(compiler):
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, 'openmp_check.cpp')
+        with open(source, 'w') as f:
+            f.write(OPENMP_CHECK)
+        try:
+            objects = compiler.compile([source], output_dir=tmp, extra_postargs=['-fopenmp'])
+            compiler.link_executable(objects, os.path.join(tmp, 'openmp_check'), extra_postargs=['-fopenmp'])
+        except (CompileError, LinkError):
+            return False
+    return True
+
+
+class BuildExt(build_ext):
+    def build_extensions(self):
+        if self.compiler.compiler_type == 'msvc':
+            compile_args, link_args = ['/std:c++14', '/O2', '/EHsc'], []
+        else:
+            compile_args, link_args = ['-std=c++14', '-O3'], []
+            if has_openmp(self.compiler):
+                compile_args.append('-fopenmp')
+                link_args.append('-fopenmp')
+        for ext in self.extensions:
+            ext.extra_compile_args = compile_args
+            ext.extra_link_args = link_args
+        build_ext.build_extensions(self)
+
+
+gnncpu = Extension(
+    'gnncpu',
+    sources=['cpp_implementation/python_module.cpp'],
+    include_dirs=['cpp_implementation'],
+    language='c++',
+)
+
+setup(name='gnncpu', version='0.1', ext_modules=[gnncpu], cmdclass={'build_ext': BuildExt})